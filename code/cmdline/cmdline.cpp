@@ -157,7 +157,8 @@ Flag exe_params[] =
 	{ "-noparseerrors",		"Disable parsing errors",					true,	0,					EASY_DEFAULT,		"Troubleshoot",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-noparseerrors", },
 	{ "-query_speech",		"Check if this build has speech",			true,	0,					EASY_DEFAULT,		"Troubleshoot",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-query_speech", },
 	{ "-novbo",				"Disable OpenGL VBO",						true,	0,					EASY_DEFAULT,		"Troubleshoot",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-novbo", },
-	{ "-noibx",				"Don't use cached index buffers (IBX)",		true,	0,					EASY_DEFAULT,		"Troubleshoot",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-noibx", },
+	{ "-noibx",				"Don't use cached IBX or BCX files",		true,	0,					EASY_DEFAULT,		"Troubleshoot",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-noibx", },
+	{ "-notablecache",		"Don't use cached table text",				true,	0,					EASY_DEFAULT,		"Troubleshoot",	"", },
 	{ "-loadallweps",		"Load all weapons, even those not used",	true,	0,					EASY_DEFAULT,		"Troubleshoot",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-loadallweps", },
 	{ "-disable_fbo",		"Disable OpenGL RenderTargets",				true,	0,					EASY_DEFAULT,		"Troubleshoot",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-disable_fbo", },
 	{ "-disable_pbo",		"Disable OpenGL Pixel Buffer Objects",		true,	0,					EASY_DEFAULT,		"Troubleshoot",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-disable_pbo", },
@@ -192,6 +193,7 @@ Flag exe_params[] =
 	{ "-reparse_mainhall",	"Reparse mainhall.tbl when loading halls",	false,	0,					EASY_DEFAULT,		"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-reparse_mainhall", },
 	{ "-profile_frame_time","Profile engine subsystems",				true,	0,					EASY_DEFAULT,		"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-profile_frame_timings", },
 	{ "-profile_write_file", "Write profiling information to file",		true,	0,					EASY_DEFAULT,		"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-profile_write_file", },
+	{ "-profile_trace",		"Write a Chrome trace of profiled code",	true,	0,					EASY_DEFAULT,		"Dev Tool",		"", },
 	{ "-no_unfocused_pause","Don't pause if the window isn't focused",	true,	0,					EASY_DEFAULT,		"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-no_unfocused_pause", },
 };
 
@@ -364,6 +366,7 @@ int Cmdline_objupd = 3;		// client object updates on LAN by default
 cmdline_parm loadallweapons_arg("-loadallweps", NULL);	// Cmdline_load_all_weapons
 cmdline_parm htl_arg("-nohtl", NULL);				// Cmdline_nohtl  -- don't use HT&L
 cmdline_parm noibx_arg("-noibx", NULL);				// Cmdline_noibx
+cmdline_parm notablecache_arg("-notablecache", NULL);	// Cmdline_notablecache
 cmdline_parm nomovies_arg("-nomovies", NULL);		// Cmdline_nomovies  -- Allows video streaming
 cmdline_parm no_set_gamma_arg("-no_set_gamma", NULL);	// Cmdline_no_set_gamma
 cmdline_parm no_vbo_arg("-novbo", NULL);			// Cmdline_novbo
@@ -380,6 +383,7 @@ cmdline_parm keyboard_layout("-keyboard_layout", NULL);
 int Cmdline_load_all_weapons = 0;
 int Cmdline_nohtl = 0;
 int Cmdline_noibx = 0;
+int Cmdline_notablecache = 0;
 int Cmdline_nomovies = 0;
 int Cmdline_no_set_gamma = 0;
 int Cmdline_novbo = 0; // turn off OGL VBO support, troubleshooting
@@ -416,6 +420,7 @@ cmdline_parm parse_cmdline_only(PARSE_COMMAND_LINE_STRING, NULL);
 cmdline_parm reparse_mainhall_arg("-reparse_mainhall", NULL); //Cmdline_reparse_mainhall
 cmdline_parm frame_profile_arg("-profile_frame_time", NULL); //Cmdline_frame_profile
 cmdline_parm frame_profile_write_file("-profile_write_file", NULL); // Cmdline_profile_write_file
+cmdline_parm frame_profile_trace("-profile_trace", NULL); // Cmdline_profile_trace
 cmdline_parm no_unfocused_pause_arg("-no_unfocused_pause", NULL); //Cmdline_no_unfocus_pause
 
 char *Cmdline_start_mission = NULL;
@@ -439,6 +444,7 @@ int Cmdline_no_grab = 0;
 int Cmdline_reparse_mainhall = 0;
 bool Cmdline_frame_profile = false;
 bool Cmdline_profile_write_file = false;
+bool Cmdline_profile_trace = false;
 bool Cmdline_no_unfocus_pause = false;
 
 // Other
@@ -1496,6 +1502,10 @@ bool SetCmdlineParams()
 		Cmdline_noibx = 1;
 	}
 
+	if ( notablecache_arg.found() ) {
+		Cmdline_notablecache = 1;
+	}
+
 	if ( no_fbo_arg.found() ) {
 		Cmdline_no_fbo = 1;
 	}
@@ -1579,6 +1589,12 @@ bool SetCmdlineParams()
 		Cmdline_profile_write_file = true;
 	}
 
+	if (frame_profile_trace.found())
+	{
+		Cmdline_frame_profile = true;
+		Cmdline_profile_trace = true;
+	}
+
 	if (no_unfocused_pause_arg.found())
 	{
 		Cmdline_no_unfocus_pause = true;
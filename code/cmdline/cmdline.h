@@ -115,6 +115,7 @@ extern int Cmdline_objupd;
 extern int Cmdline_load_all_weapons;
 extern int Cmdline_nohtl;
 extern int Cmdline_noibx;
+extern int Cmdline_notablecache;
 extern int Cmdline_nomovies;	// WMC Toggles movie playing support
 extern int Cmdline_no_set_gamma;
 extern int Cmdline_novbo;
@@ -146,6 +147,7 @@ extern int Cmdline_verify_vps;
 extern int Cmdline_reparse_mainhall;
 extern bool Cmdline_frame_profile;
 extern bool Cmdline_profile_write_file;
+extern bool Cmdline_profile_trace;
 extern bool Cmdline_no_unfocus_pause;
 
 #endif
@@ -107,6 +107,7 @@
 #include "network/multi_endgame.h"
 #include "network/multi_ingame.h"
 #include "network/multi_log.h"
+#include "network/multi_metrics.h"
 #include "network/multi_pause.h"
 #include "network/multi_pxo.h"
 #include "network/multi_rate.h"
@@ -4021,7 +4022,9 @@ void game_simulation_frame()
 		// move all the objects now
 		PROFILE("Move Objects - Master", obj_move_all(flFrametime));
 
+		int sexp_start = timer_get_microseconds();
 		mission_eval_goals();
+		multi_metrics_observe(MM_HIST_SEXP_EVAL_TIME, (timer_get_microseconds() - sexp_start) / 1000000.0f);
 	}
 
 	// always check training objectives, even in multiplayer missions. we need to do this so that the directives gauge works properly on clients
@@ -4353,7 +4356,8 @@ void game_frame(bool paused)
 #endif
 	// start timing frame
 	timing_frame_start();
-	profile_begin("Main Frame");
+	static int main_frame_site = profile_site("Main Frame");
+	profile_begin(main_frame_site);
 
 	DEBUG_GET_TIME( total_time1 )
 
@@ -4543,7 +4547,7 @@ void game_frame(bool paused)
 	// process lightning (nebula only)
 	nebl_process();
 
-	profile_end("Main Frame");
+	profile_end(main_frame_site);
 	profile_dump_output();
 
 	DEBUG_GET_TIME( total_time2 )
@@ -4677,7 +4681,6 @@ void set_time_compression(float multiplier, float change_time)
 void game_set_frametime(int state)
 {
 	fix thistime;
-	float frame_cap_diff;
 
 	thistime = timer_get_fixed_seconds();
 
@@ -4714,8 +4717,13 @@ void game_set_frametime(int state)
 
 	Assertion( Framerate_cap > 0, "Framerate cap %d is too low. Needs to be a positive, non-zero number", Framerate_cap );
 
+	if (Game_mode & GM_STANDALONE_SERVER) {
+		// the standalone runs on its own tick schedule, only waking early for network data while idle
+		thistime = multi_tick_wait(state == GS_STATE_STANDALONE_MAIN);
+		Frametime = thistime - Last_time;
+	}
 	// Cap the framerate so it doesn't get too high.
-	if (!Cmdline_NoFPSCap)
+	else if (!Cmdline_NoFPSCap)
 	{
 		fix cap;
 
@@ -4729,17 +4737,6 @@ void game_set_frametime(int state)
 		}
 	}
 
-	if((Game_mode & GM_STANDALONE_SERVER) && 
-		(f2fl(Frametime) < ((float)1.0/(float)Multi_options_g.std_framecap))){
-
-		frame_cap_diff = ((float)1.0/(float)Multi_options_g.std_framecap) - f2fl(Frametime);		
-		Sleep((DWORD)(frame_cap_diff*1000)); 				
-		
-		thistime += fl2f((frame_cap_diff));		
-
-		Frametime = thistime - Last_time;
-   }
-
 	// If framerate is too low, cap it.
 	if (Frametime > MAX_FRAMETIME)	{
 #ifndef NDEBUG
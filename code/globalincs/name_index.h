@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) Freespace Open 2026.  All rights reserved.
+ *
+ * All source code herein is the property of Freespace Open. You may not sell
+ * or otherwise commercially exploit the source or things you created based on the
+ * source.
+ *
+*/
+
+
+
+#ifndef _NAME_INDEX_H
+#define _NAME_INDEX_H
+
+#include <ctype.h>
+
+#include "globalincs/pstypes.h"
+
+// Case-insensitive name -> index lookup for the parsed info tables (Ship_info, Weapon_info, Iff_info, ...),
+// which would otherwise be scanned with stricmp on every lookup.
+//
+// The owning table hands in its current count and a function returning the name of an entry.  Entries
+// appended since the last lookup are indexed on the fly, so lookups made while a table is still being
+// parsed work too, as long as an entry is named before it is counted.  Anything that reorders, renames or
+// refills entries must call invalidate(); a miss is trusted and returns -1 without looking at the table.
+// A hit whose name no longer matches still causes a rebuild, and two names with the same hash fall back
+// to a linear scan.
+class name_index
+{
+public:
+	typedef const char *(*name_func)(int idx);
+
+	name_index() : Count(0) {}
+
+	void invalidate()
+	{
+		Index.clear();
+		Count = 0;
+	}
+
+	int lookup(const char *name, int count, name_func name_of)
+	{
+		if (name == NULL)
+			return -1;
+
+		int idx = find(name, count, name_of);
+
+		// a stale entry; start again from scratch
+		if (idx == STALE) {
+			invalidate();
+			idx = find(name, count, name_of);
+		}
+
+		if (idx == MISSING)
+			return -1;
+
+		// two names with the same hash; do it the old way
+		if (idx == COLLISION) {
+			for (int i = 0; i < count; i++) {
+				if (!stricmp(name, name_of(i)))
+					return i;
+			}
+
+			return -1;
+		}
+
+		return idx;
+	}
+
+private:
+	enum { MISSING = -1, COLLISION = -2, STALE = -3 };
+
+	SCP_hash_map<uint, int> Index;
+	int Count;		// number of table entries indexed so far
+
+	// FNV-1a over the lowercased name
+	static uint hash(const char *name)
+	{
+		uint h = 2166136261u;
+
+		for (const char *p = name; *p; p++) {
+			h ^= (uint)tolower((unsigned char)*p);
+			h *= 16777619u;
+		}
+
+		return h;
+	}
+
+	int find(const char *name, int count, name_func name_of)
+	{
+		// the table was cleared out and reparsed
+		if (count < Count)
+			invalidate();
+
+		for (; Count < count; Count++) {
+			const char *entry = name_of(Count);
+			SCP_hash_map<uint, int>::iterator ii = Index.find(hash(entry));
+
+			// the first entry with a name wins, same as a linear scan
+			if (ii == Index.end())
+				Index[hash(entry)] = Count;
+			else if ((ii->second >= 0) && stricmp(entry, name_of(ii->second)))
+				ii->second = COLLISION;
+		}
+
+		SCP_hash_map<uint, int>::iterator ii = Index.find(hash(name));
+		if (ii == Index.end())
+			return MISSING;
+
+		if (ii->second < 0)
+			return ii->second;
+
+		return stricmp(name, name_of(ii->second)) ? STALE : ii->second;
+	}
+};
+
+#endif // _NAME_INDEX_H
@@ -1,17 +1,20 @@
 /*
  * Copyright (C) Freespace Open 2013.  All rights reserved.
  *
- * All source code herein is the property of Freespace Open. You may not sell 
- * or otherwise commercially exploit the source or things you created based on the 
+ * All source code herein is the property of Freespace Open. You may not sell
+ * or otherwise commercially exploit the source or things you created based on the
  * source.
  *
-*/ 
+*/
 
 #include "globalincs/pstypes.h"
 #include "globalincs/systemvars.h"
 #include "io/timer.h"
 #include "cmdline/cmdline.h"
 
+#include "SDL_timer.h"
+#include "SDL_mutex.h"
+
 #include <fstream>
 
 //======================CODE TO PROFILE PERFORMANCE=====================
@@ -22,32 +25,184 @@
  * pstypes.h.
  * Example:
  * PROFILE("Render", game_render_frame( cid ));
- * 
+ *
  * If you want to profile a block of function calls, you will need to use the profile_begin()/profile_end() calls.
  * Example:
- * profile_begin("Some Code");
+ * static int site = profile_site("Some Code");
+ * profile_begin(site);
  * ...some code...
- * profile_end("Some Code");
- * Note that the parameter passed MUST be globally unique across all instances of profiling invocations.
+ * profile_end(site);
+ * The name versions, profile_begin("Some Code") and profile_end("Some Code"), also work but have to look the
+ * name up every time.  Note that the name MUST be globally unique across all instances of profiling invocations.
  *
  * Profiling invocations can be nested as deep as necessary; this will show up in the readout as indentations.
+ * Sections can be profiled from any thread.  The HUD readout only shows the main thread; worker threads should
+ * call profile_thread_name() when they start and profile_thread_exit() before they return, so that they can be
+ * told apart in the trace.
+ *
+ * With -profile_trace, every section also goes into a ring buffer kept per thread, and the buffers are written
+ * out as a Chrome trace (chrome://tracing or ui.perfetto.dev) to profiling_trace.json on exit, or whenever the
+ * profile_trace console command is used.
  */
 
-SCP_vector<profile_sample> samples;
-SCP_vector<profile_sample_history> history;
-
-float start_profile_time = 0.0f;
-float end_profile_time = 0.0f;
+// number of sections remembered per thread for the trace
+#define PROFILE_TRACE_EVENTS		65536
+
+typedef struct profile_site_info {
+	char name[256];
+} profile_site_info;
+
+// a section that has been started but not ended yet
+typedef struct profile_open_section {
+	int site;
+	Uint64 start_time;
+	Uint64 children_time;
+} profile_open_section;
+
+// what a thread has seen of a site since the last profile_dump_output()
+typedef struct profile_sample {
+	bool valid;
+	uint profile_instances;
+	uint num_parents;
+	Uint64 accumulator;
+	Uint64 children_sample_time;
+} profile_sample;
+
+typedef struct profile_sample_history {
+	bool valid;
+	float avg;
+	float min;
+	float max;
+} profile_sample_history;
+
+typedef struct profile_trace_event {
+	int site;
+	Uint64 start_time;
+	Uint64 duration;
+} profile_trace_event;
+
+typedef struct profile_thread {
+	char name[64];
+	bool in_use;
+
+	SCP_vector<profile_open_section> stack;
+	SCP_vector<profile_sample> samples;			// indexed by site
+	SCP_vector<int> sample_order;				// sites in the order they were first ended this frame
+
+	profile_trace_event *events;				// ring buffer, NULL unless tracing
+	uint num_events;							// total ever written; the buffer holds the latest ones
+} profile_thread;
+
+static SCP_vector<profile_site_info> Profile_sites;
+static SCP_vector<profile_thread*> Profile_threads;
+static SCP_vector<profile_sample_history> history;		// indexed by site
+
+static SDL_mutex *Profile_mutex = NULL;
+static SCP_THREAD_LOCAL profile_thread *Profile_this_thread = NULL;
+static profile_thread *Profile_main_thread = NULL;
+
+static Uint64 Profile_counter_base = 0;
+static Uint64 Profile_counter_freq = 1;
+
+static Uint64 start_profile_time = 0;
+static Uint64 end_profile_time = 0;
 
 char profile_output[2048] = "";
 std::ofstream profiling_file;
 
+static void profile_lock()
+{
+	// sites can be registered before profile_init(), while there's only one thread anyway
+	if (Profile_mutex != NULL)
+		SDL_LockMutex(Profile_mutex);
+}
+
+static void profile_unlock()
+{
+	if (Profile_mutex != NULL)
+		SDL_UnlockMutex(Profile_mutex);
+}
+
+/**
+ * @brief Nanoseconds since profile_init()
+ */
+static Uint64 profile_get_time()
+{
+	Uint64 counter = SDL_GetPerformanceCounter() - Profile_counter_base;
+
+	// split up so that the multiply can't overflow
+	return (counter / Profile_counter_freq) * 1000000000 + ((counter % Profile_counter_freq) * 1000000000) / Profile_counter_freq;
+}
+
+/**
+ * @brief Sets up the calling thread's profiling data under the given name, reusing that of an earlier thread
+ * that had the same name and has exited.
+ */
+static profile_thread *profile_attach_thread(const char *name)
+{
+	profile_thread *pt = NULL;
+	size_t i;
+
+	profile_lock();
+
+	for (i = 0; i < Profile_threads.size(); i++) {
+		if (!Profile_threads[i]->in_use && !strcmp(Profile_threads[i]->name, name)) {
+			pt = Profile_threads[i];
+			break;
+		}
+	}
+
+	if (pt == NULL) {
+		pt = new profile_thread;
+
+		strcpy_s(pt->name, name);
+		pt->events = NULL;
+		pt->num_events = 0;
+
+		if (Cmdline_profile_trace)
+			pt->events = new profile_trace_event[PROFILE_TRACE_EVENTS];
+
+		Profile_threads.push_back(pt);
+	}
+
+	pt->in_use = true;
+	pt->stack.clear();
+
+	profile_unlock();
+
+	Profile_this_thread = pt;
+
+	return pt;
+}
+
+static profile_thread *profile_get_thread()
+{
+	if (Profile_this_thread != NULL)
+		return Profile_this_thread;
+
+	char name[64];
+	sprintf(name, "Thread %d", (int)Profile_threads.size());
+
+	return profile_attach_thread(name);
+}
+
 /**
  * @brief Called once at engine initialization to set the timer
  */
 void profile_init()
 {
-	start_profile_time = f2fl(timer_get_fixed_seconds());
+	if (Profile_mutex == NULL)
+		Profile_mutex = SDL_CreateMutex();
+
+	Profile_counter_base = SDL_GetPerformanceCounter();
+	Profile_counter_freq = SDL_GetPerformanceFrequency();
+
+	if (Profile_counter_freq == 0)
+		Profile_counter_freq = 1;
+
+	start_profile_time = profile_get_time();
+
+	Profile_main_thread = profile_attach_thread("Main");
 
 	if (Cmdline_profile_write_file)
 	{
@@ -70,215 +225,402 @@ void profile_deinit()
 			profiling_file.close();
 		}
 	}
+
+	if (Cmdline_profile_trace)
+	{
+		if (!profile_write_trace("profiling_trace.json"))
+		{
+			mprintf(("Failed to write profiling trace 'profiling_trace.json'!\n"));
+		}
+	}
+
+	for (size_t i = 0; i < Profile_threads.size(); i++) {
+		if (Profile_threads[i]->events)
+			delete[] Profile_threads[i]->events;
+
+		delete Profile_threads[i];
+	}
+
+	Profile_threads.clear();
+	Profile_this_thread = NULL;
+	Profile_main_thread = NULL;
+
+	if (Profile_mutex != NULL) {
+		SDL_DestroyMutex(Profile_mutex);
+		Profile_mutex = NULL;
+	}
 }
 
 /**
- * Used to start profiling a section of code. A section started by profile_begin needs to be closed off by calling
- * profile_end with the same argument.
+ * Gets the id of a profiling site, adding it if this is the first time the name is used.
  * @param name A globally unique string that will be displayed in the HUD readout
  */
-void profile_begin(char* name)
+int profile_site(const char *name)
 {
-	if (Cmdline_frame_profile)
-	{
-		for(int i = 0; i < (int)samples.size(); i++) {
-			if(samples[i].valid && !strcmp(samples[i].name, name) ) {
-				// found the profile sample
-				samples[i].open_profiles++;
-				samples[i].profile_instances++;
-				samples[i].start_time = f2fl(timer_get_fixed_seconds());
-				Assert(samples[i].open_profiles == 1); // max 1 open at once
-				return;
-			}
+	int site = -1;
+
+	profile_lock();
+
+	for (int i = 0; i < (int)Profile_sites.size(); i++) {
+		if (!strcmp(Profile_sites[i].name, name)) {
+			site = i;
+			break;
 		}
+	}
 
-		// create a new profile sample
-		profile_sample new_sample;
+	if (site < 0) {
+		profile_site_info info;
 
-		strcpy_s(new_sample.name, name);
-		new_sample.valid = true;
-		new_sample.open_profiles = 1;
-		new_sample.profile_instances = 1;
-		new_sample.accumulator = 0.0f;
-		new_sample.start_time = f2fl(timer_get_fixed_seconds());
-		new_sample.children_sample_time = 0.0f;
+		strcpy_s(info.name, name);
+		Profile_sites.push_back(info);
 
-		samples.push_back(new_sample);
+		site = (int)Profile_sites.size() - 1;
 	}
+
+	profile_unlock();
+
+	return site;
+}
+
+/**
+ * Names the calling thread in the trace. Worker threads should call this when they start.
+ */
+void profile_thread_name(const char *name)
+{
+	if (!Cmdline_frame_profile)
+		return;
+
+	if (Profile_this_thread != NULL)
+		profile_thread_exit();
+
+	profile_attach_thread(name);
+}
+
+/**
+ * Lets the calling thread's profiling data be reused by a later thread of the same name. Worker threads should
+ * call this just before they return.
+ */
+void profile_thread_exit()
+{
+	if (Profile_this_thread == NULL)
+		return;
+
+	profile_lock();
+	Profile_this_thread->in_use = false;
+	profile_unlock();
+
+	Profile_this_thread = NULL;
+}
+
+/**
+ * Used to start profiling a section of code. A section started by profile_begin needs to be closed off by calling
+ * profile_end with the same argument.
+ * @param site The id from profile_site()
+ */
+void profile_begin(int site)
+{
+	if (!Cmdline_frame_profile)
+		return;
+
+	profile_thread *pt = profile_get_thread();
+	profile_open_section section;
+
+	section.site = site;
+	section.children_time = 0;
+	section.start_time = profile_get_time();
+
+	// a section that was never ended, like the main frame when game_frame() returns early, is dropped when it starts again
+	for (int i = 0; i < (int)pt->stack.size(); i++) {
+		if (pt->stack[i].site == site) {
+			pt->stack.resize(i);
+			break;
+		}
+	}
+
+	pt->stack.push_back(section);
 }
 
 /**
  * Used to end profiling of a section of code. Note that the parameter given MUST match that of the preceding call
  * to profile_begin
- * @param name A globally unique string that will be displayed in the HUD readout
+ * @param site The id from profile_site()
  */
-void profile_end(char* name)
+void profile_end(int site)
 {
-	if (Cmdline_frame_profile) {
-		int num_parents = 0;
-
-		for(int i = 0; i < (int)samples.size(); i++) {
-			if(samples[i].valid && !strcmp(samples[i].name, name) ) {
-				int inner = 0;
-				int parent = -1;
-				float end_time = f2fl(timer_get_fixed_seconds());
-				samples[i].open_profiles--;
-
-				// count all parents and find the immediate parent
-				while(samples[inner].valid && inner < (int)samples.size()) {
-					if(samples[inner].open_profiles > 0) {
-						// found a parent (any open profiles are parents)
-						num_parents++;
-
-						if(parent < 0) {
-							// replace invalid parent (index)
-							parent = inner;
-						} else if(samples[inner].start_time >= samples[parent].start_time) {
-							// replace with more immediate parent
-							parent = inner;
-						}
-					}
-					inner++;
-				}
-
-				// remember the current number of parents of the sample
-				samples[i].num_parents = num_parents;
-
-				if(parent >= 0) {
-					// record this time in children_sample_time (add it in)
-					samples[parent].children_sample_time += end_time - samples[i].start_time;
-				}
-
-				// save sample time in accumulator
-				samples[i].accumulator += end_time - samples[i].start_time;
-			
-				return;
-			}
-		}
+	if (!Cmdline_frame_profile)
+		return;
+
+	Uint64 end_time = profile_get_time();
+	profile_thread *pt = profile_get_thread();
+
+	// a section left open by an early return is dropped when one it was nested in ends
+	int depth = (int)pt->stack.size() - 1;
+
+	while ((depth >= 0) && (pt->stack[depth].site != site))
+		depth--;
+
+	if (depth < 0)
+		return;
+
+	pt->stack.resize(depth + 1);
+
+	profile_open_section section = pt->stack.back();
+	pt->stack.pop_back();
+
+	Uint64 duration = end_time - section.start_time;
+
+	// record this time in the parent's children_sample_time
+	if (!pt->stack.empty())
+		pt->stack.back().children_time += duration;
+
+	if (site >= (int)pt->samples.size()) {
+		profile_sample empty;
+
+		memset(&empty, 0, sizeof(empty));
+		pt->samples.resize(site + 1, empty);
+	}
+
+	profile_sample *sample = &pt->samples[site];
+
+	if (!sample->valid) {
+		sample->valid = true;
+		pt->sample_order.push_back(site);
 	}
+
+	sample->profile_instances++;
+	sample->num_parents = pt->stack.size();
+	sample->accumulator += duration;
+	sample->children_sample_time += section.children_time;
+
+	if (pt->events != NULL) {
+		profile_trace_event *event = &pt->events[pt->num_events % PROFILE_TRACE_EVENTS];
+
+		event->site = site;
+		event->start_time = section.start_time;
+		event->duration = duration;
+
+		pt->num_events++;
+	}
+}
+
+/**
+ * Name versions of profile_begin()/profile_end(), for code that doesn't keep the site id
+ */
+void profile_begin(const char *name)
+{
+	if (Cmdline_frame_profile)
+		profile_begin(profile_site(name));
+}
+
+void profile_end(const char *name)
+{
+	if (Cmdline_frame_profile)
+		profile_end(profile_site(name));
 }
 
 /**
- * Builds the output text.
+ * Stores profile data in in the profile history lookup. This is used internally by the profiling code and should
+ * not be called outside of it.
+ * @param site The site id of this profile (see profile_site())
+ * @param percent How much time the profiled section took to execute (as a percentage of overall frametime)
+ */
+static void store_profile_in_history(int site, float percent)
+{
+	float old_ratio;
+	float new_ratio = 0.8f * f2fl(Frametime);
+
+	if(new_ratio > 1.0f) {
+		new_ratio = 1.0f;
+	}
+
+	old_ratio = 1.0f - new_ratio;
+
+	if (site >= (int)history.size()) {
+		profile_sample_history empty;
+
+		memset(&empty, 0, sizeof(empty));
+		history.resize(site + 1, empty);
+	}
+
+	profile_sample_history *h = &history[site];
+
+	if (!h->valid) {
+		// add to history
+		h->valid = true;
+		h->avg = h->min = h->max = percent;
+		return;
+	}
+
+	h->avg = (h->avg * old_ratio) + (percent * new_ratio);
+
+	if( percent < h->min ) {
+		h->min = percent;
+	} else {
+		h->min = (h->min*old_ratio) + (percent*new_ratio);
+	}
+
+	if( percent > h->max) {
+		h->max = percent;
+	} else {
+		h->max = (h->max * old_ratio) + (percent * new_ratio);
+	}
+}
+
+/**
+ * Builds the output text from what the main thread profiled since the last call.
  */
 void profile_dump_output()
 {
-	if (Cmdline_frame_profile) {
-		end_profile_time = f2fl(timer_get_fixed_seconds());
+	if (Cmdline_frame_profile && Profile_main_thread != NULL) {
+		profile_thread *pt = Profile_main_thread;
+
+		end_profile_time = profile_get_time();
 
 		if (Cmdline_profile_write_file)
 		{
-			profiling_file << end_profile_time << ";" << (end_profile_time - start_profile_time) << std::endl;
+			profiling_file << (end_profile_time / 1000000000.0) << ";" << ((end_profile_time - start_profile_time) / 1000000000.0) << std::endl;
 		}
 
 		strcpy_s(profile_output, "");
-		strcat(profile_output, "  Avg :  Min :  Max :   # : Profile Name\n");
-		strcat(profile_output, "----------------------------------------\n");
+		strcat_s(profile_output, "  Avg :  Min :  Max :   # : Profile Name\n");
+		strcat_s(profile_output, "----------------------------------------\n");
 
-		for(int i = 0; i < (int)samples.size(); i++) {
-			float sample_time, percent_time, avg_time, min_time, max_time;
+		for(int i = 0; i < (int)pt->sample_order.size(); i++) {
+			int site = pt->sample_order[i];
+			profile_sample *sample = &pt->samples[site];
+			float percent_time;
 			char line[256], name[256], indented_name[256];
 			char avg[16], min[16], max[16], num[16];
 
-			Assert(samples[i].open_profiles == 0);
-
-			sample_time = samples[i].accumulator - samples[i].children_sample_time;
+			Uint64 sample_time = sample->accumulator - sample->children_sample_time;
 
 			if (end_profile_time == start_profile_time) {
 				percent_time = 0.0f;
 			} else {
-				percent_time = (sample_time / (end_profile_time - start_profile_time)) *100.0f;
+				percent_time = ((float)sample_time / (float)(end_profile_time - start_profile_time)) *100.0f;
 			}
 
-			avg_time = min_time = max_time = percent_time;
-
 			// add new measurement into the history and get avg, min, and max
-			store_profile_in_history(samples[i].name, percent_time);
-			get_profile_from_history(samples[i].name, &avg_time, &min_time, &max_time);
+			store_profile_in_history(site, percent_time);
+
 			// format the data
-			sprintf(avg, "%3.1f", avg_time);
-			sprintf(min, "%3.1f", min_time);
-			sprintf(max, "%3.1f", max_time);
-			sprintf(num, "%3d", samples[i].profile_instances);
+			sprintf(avg, "%3.1f", history[site].avg);
+			sprintf(min, "%3.1f", history[site].min);
+			sprintf(max, "%3.1f", history[site].max);
+			sprintf(num, "%3d", sample->profile_instances);
+
+			// worker threads can add sites (and so move Profile_sites) at any time
+			profile_lock();
+			strcpy_s(indented_name, Profile_sites[site].name);
+			profile_unlock();
 
-			strcpy(indented_name, samples[i].name);
-			for(uint indent = 0; indent < samples[i].num_parents; indent++) {
+			for(uint indent = 0; indent < sample->num_parents; indent++) {
 				sprintf(name, "   %s", indented_name);
 				strcpy_s(indented_name, name);
 			}
 
 			sprintf(line, "%5s : %5s : %5s : %3s : %s\n", avg, min, max, num, indented_name);
-			strcat(profile_output, line);
+
+			if (strlen(profile_output) + strlen(line) < sizeof(profile_output))
+				strcat_s(profile_output, line);
+
+			memset(sample, 0, sizeof(profile_sample));
 		}
 
-		samples.clear();
-		start_profile_time = f2fl(timer_get_fixed_seconds());
+		pt->sample_order.clear();
+		start_profile_time = profile_get_time();
+	}
+}
+
+static void profile_write_json_string(std::ofstream &out, const char *str)
+{
+	out << '"';
+
+	for (const char *p = str; *p; p++) {
+		if (*p == '"' || *p == '\\')
+			out << '\\';
+
+		if ((unsigned char)*p >= 0x20)
+			out << *p;
 	}
+
+	out << '"';
 }
 
 /**
- * Stores profile data in in the profile history lookup. This is used internally by the profiling code and should
- * not be called outside of it.
- * @param name The globally unique name for this profile (see profile_begin()/profile_end())
- * @param percent How much time the profiled section took to execute (as a percentage of overall frametime)
+ * Writes the trace buffers of all threads in the Chrome trace event format. Only has anything to write with
+ * -profile_trace.
+ * @param filename Where to write it, relative to the working directory like profiling.csv
+ * @return false if the file couldn't be written
  */
-void store_profile_in_history(char* name, float percent)
+bool profile_write_trace(const char *filename)
 {
-	float old_ratio;
-	float new_ratio = 0.8f * f2fl(Frametime);
+	std::ofstream out(filename);
 
-	if(new_ratio > 1.0f) {
-		new_ratio = 1.0f;
-	}
+	if (!out.good())
+		return false;
 
-	old_ratio = 1.0f - new_ratio;
+	out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
 
-	for(int i = 0; i < (int)history.size(); i++) {
-		if( history[i].valid && !strcmp(history[i].name, name) ) {
-			// found the sample
-			history[i].avg = (history[i].avg * old_ratio) + (percent * new_ratio);
+	bool first = true;
 
-			if( percent < history[i].min ) {
-				history[i].min = percent;
-			} else {
-				history[i].min = (history[i].min*old_ratio) + (percent*new_ratio);
-			}
+	profile_lock();
 
-			if( percent > history[i].max) {
-				history[i].max = percent;
-			} else {
-				history[i].max = (history[i].max * old_ratio) + (percent * new_ratio);
-			}
-			return;
+	for (size_t t = 0; t < Profile_threads.size(); t++) {
+		profile_thread *pt = Profile_threads[t];
+		int tid = (int)t + 1;
+
+		out << (first ? "\n" : ",\n");
+		first = false;
+
+		out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":";
+		profile_write_json_string(out, pt->name);
+		out << "}}";
+
+		if (pt->events == NULL)
+			continue;
+
+		uint count = MIN(pt->num_events, (uint)PROFILE_TRACE_EVENTS);
+
+		for (uint i = pt->num_events - count; i < pt->num_events; i++) {
+			profile_trace_event *event = &pt->events[i % PROFILE_TRACE_EVENTS];
+
+			// timestamps are in microseconds
+			out << ",\n{\"name\":";
+			profile_write_json_string(out, Profile_sites[event->site].name);
+			out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid;
+			out << ",\"ts\":" << (event->start_time / 1000) << "." << (int)((event->start_time % 1000) / 100);
+			out << ",\"dur\":" << (event->duration / 1000) << "." << (int)((event->duration % 1000) / 100) << "}";
 		}
 	}
 
-	// add to history
-	profile_sample_history new_history;
+	profile_unlock();
 
-	strcpy_s(new_history.name, name);
-	new_history.valid = true;
-	new_history.avg = new_history.min = new_history.max = percent;
+	out << "\n]}\n";
+	out.close();
 
-	history.push_back(new_history);
+	return true;
 }
 
-/**
- * Gets the min, max and average values for a given profile
- * @param name The globally unique name for this profile (see profile_begin()/profile_end())
- * @param avg Pointer to a float in which the average value will be stored (or 0.0 if no value has been saved)
- * @param min Pointer to a float in which the minimum value will be stored (or 0.0 if no value has been saved)
- * @param max Pointer to a float in which the maximum value will be stored (or 0.0 if no value has been saved)
- */
-void get_profile_from_history(char* name, float* avg, float* min, float* max)
+DCF(profile_trace, "Writes the profiler trace of every thread to a Chrome trace file")
 {
-	for(int i = 0; i < (int)history.size(); i++) {
-		if(!strcmp(history[i].name, name)) {
-			*avg = history[i].avg;
-			*min = history[i].min;
-			*max = history[i].max;
-			return;
-		}
+	if (Dc_command)
+	{
+		dc_get_arg(ARG_STRING | ARG_NONE);
+		const char *filename = (Dc_arg_type & ARG_STRING) ? Dc_arg : "profiling_trace.json";
+
+		if (!Cmdline_profile_trace)
+			dc_printf("Nothing is traced without -profile_trace\n");
+		else if (profile_write_trace(filename))
+			dc_printf("Trace written to %s\n", filename);
+		else
+			dc_printf("Could not open %s for writing\n", filename);
 	}
-	*avg = *min = *max = 0.0f;
-}
\ No newline at end of file
+
+	if (Dc_help)
+	{
+		dc_printf("Usage: profile_trace [file]\nWrites the last %d profiled sections of each thread to file, or profiling_trace.json.\n", PROFILE_TRACE_EVENTS);
+		dc_printf("Open it in chrome://tracing or ui.perfetto.dev.\n");
+		Dc_status = 0;
+	}
+}
@@ -203,6 +203,13 @@ extern int Global_error_count;
 #	define  __attribute__(x)  /*NOTHING*/
 #endif
 
+// per-thread storage for plain (POD) globals
+#ifdef _MSC_VER
+#	define SCP_THREAD_LOCAL __declspec(thread)
+#else
+#	define SCP_THREAD_LOCAL __thread
+#endif
+
 // To debug printf do this:
 // mprintf(( "Error opening %s\n", filename ));
 #ifndef NDEBUG
@@ -554,37 +561,25 @@ extern void game_busy(const char *filename = NULL);
 //=========================================================
 // Functions to profile frame performance
 
-typedef struct profile_sample {
-	bool valid;
-	uint profile_instances;
-	int open_profiles;
-	char name[256];
-	float start_time;
-	float accumulator;
-	float children_sample_time;
-	uint num_parents;
-} profile_sample;
-
-typedef struct profile_sample_history {
-	bool valid;
-	char name[256];
-	float avg;
-	float min;
-	float max;
-} profile_sample_history;
-
 extern char profile_output[2048];
 
 void profile_init();
 void profile_deinit();
-void profile_begin(char* name);
-void profile_end(char* name);
+int profile_site(const char *name);
+void profile_begin(int site);
+void profile_end(int site);
+void profile_begin(const char *name);
+void profile_end(const char *name);
 void profile_dump_output();
-void store_profile_in_history(char* name, float percent);
-void get_profile_from_history(char* name, float* avg, float* min, float* max);
+void profile_thread_name(const char *name);
+void profile_thread_exit();
+bool profile_write_trace(const char *filename);
 
 // Helper macro to encapsulate a single function call in a profile_begin()/profile_end() pair.
-#define PROFILE(name, function) { profile_begin(name); function; profile_end(name); }
+// The name is turned into a site id the first time the line runs, so later calls don't search for it.
+// That first run isn't thread safe on compilers older than MSVC 2015, so code on worker threads should
+// get its site id from profile_site() before the threads start and call profile_begin()/profile_end().
+#define PROFILE(name, function) { static int _profile_site = profile_site(name); profile_begin(_profile_site); function; profile_end(_profile_site); }
 
 
 //=========================================================
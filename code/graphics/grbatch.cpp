@@ -98,6 +98,9 @@ void geometry_batcher::add_allocate(int quad, int n_tri)
 	float *old_radius_list = radius_list;
 
 	if (to_alloc > n_allocated) {
+		// grow geometrically, since the batches are filled one primitive at a time
+		to_alloc = MAX(to_alloc, n_allocated * 2);
+
 		vert = (vertex *) vm_malloc( sizeof(vertex) * to_alloc );
 		radius_list = (float *) vm_malloc( sizeof(float) * to_alloc );
 
@@ -148,6 +151,33 @@ const geometry_batcher &geometry_batcher::operator=(const geometry_batcher &geo)
 	return *this;
 }
 
+// The axes of an unrotated bitmap only depend on the view, so they are only worked out again when
+// the view changes rather than for every bitmap.
+static void batch_get_bitmap_axes(vec3d *rvec, vec3d *uvec)
+{
+	static matrix last_view;
+	static vec3d last_rvec, last_uvec;
+	static bool axes_valid = false;
+
+	if ( !axes_valid || memcmp(&last_view, &View_matrix, sizeof(matrix)) ) {
+		// get an up vector in the general direction of what we want
+		last_uvec = View_matrix.vec.uvec;
+
+		// make a right vector from the f and up vector, this r vec is exactly what we want, so...
+		vm_vec_crossprod(&last_rvec, &View_matrix.vec.fvec, &last_uvec);
+		vm_vec_normalize_safe(&last_rvec);
+
+		// fix the u vec with it
+		vm_vec_crossprod(&last_uvec, &View_matrix.vec.fvec, &last_rvec);
+
+		last_view = View_matrix;
+		axes_valid = true;
+	}
+
+	*rvec = last_rvec;
+	*uvec = last_uvec;
+}
+
 /*
 0----1
 |\   |
@@ -165,23 +195,15 @@ void geometry_batcher::draw_bitmap(vertex *pnt, int orient, float rad, float dep
 	vertex *P = &vert[n_to_render * 3];
 	float *R = &radius_list[n_to_render * 3];
 
-	// get the direction from the point to the eye
-	vm_vec_sub(&fvec, &View_position, &PNT);
-	vm_vec_normalize_safe(&fvec);
-
-	// get an up vector in the general direction of what we want
-	uvec = View_matrix.vec.uvec;
+	batch_get_bitmap_axes(&rvec, &uvec);
 
-	// make a right vector from the f and up vector, this r vec is exactly what we want, so...
-	vm_vec_crossprod(&rvec, &View_matrix.vec.fvec, &uvec);
-	vm_vec_normalize_safe(&rvec);
+	// move the center of the sprite towards the eye based on the depth parameter
+	if ( depth != 0.0f ) {
+		vm_vec_sub(&fvec, &View_position, &PNT);
+		vm_vec_normalize_safe(&fvec);
 
-	// fix the u vec with it
-	vm_vec_crossprod(&uvec, &View_matrix.vec.fvec, &rvec);
-
-	// move the center of the sprite based on the depth parameter
-	if ( depth != 0.0f )
 		vm_vec_scale_add(&PNT, &PNT, &fvec, depth);
+	}
 
 	// move one of the verts to the left
 	vm_vec_scale_add(&p[0], &PNT, &rvec, rad);
@@ -595,46 +617,40 @@ struct batch_item {
 static SCP_vector<batch_item> geometry_map;
 static SCP_vector<batch_item> distortion_map;
 
+// texture -> index into geometry_map and distortion_map
+static SCP_hash_map<int, size_t> geometry_map_index;
+static SCP_hash_map<int, size_t> distortion_map_index;
+
 // Used for sending verts to the vertex buffer
 effect_vertex *Batch_buffer = NULL;
 size_t Batch_buffer_size = 0;
 
-static size_t find_good_batch_item(int texture)
+static size_t find_batch_item(SCP_vector<batch_item> &map, SCP_hash_map<int, size_t> &map_index, int texture)
 {
-	size_t max_size = geometry_map.size();
+	SCP_hash_map<int, size_t>::iterator it = map_index.find(texture);
 
-	for (size_t i = 0; i < max_size; i++) {
-		if (geometry_map[i].texture == texture)
-			return i;
-	}
+	if (it != map_index.end())
+		return it->second;
 
 	// don't have an existing match so add a new entry
 	batch_item new_item;
 
 	new_item.texture = texture;
 
-	geometry_map.push_back(new_item);
+	map.push_back(new_item);
+	map_index[texture] = map.size() - 1;
 
-	return (geometry_map.size() - 1);
+	return (map.size() - 1);
 }
 
-static size_t find_good_distortion_item(int texture)
+static size_t find_good_batch_item(int texture)
 {
-	size_t max_size = distortion_map.size();
-
-	for (size_t i = 0; i < max_size; i++) {
-		if (distortion_map[i].texture == texture)
-			return i;
-	}
-
-	// don't have an existing match so add a new entry
-	batch_item new_item;
-
-	new_item.texture = texture;
-
-	distortion_map.push_back(new_item);
+	return find_batch_item(geometry_map, geometry_map_index, texture);
+}
 
-	return (distortion_map.size() - 1);
+static size_t find_good_distortion_item(int texture)
+{
+	return find_batch_item(distortion_map, distortion_map_index, texture);
 }
 
 float batch_add_laser(int texture, vec3d *p0, float width1, vec3d *p1, float width2, int r, int g, int b)
@@ -818,10 +834,11 @@ void batch_render_all(int stream_buffer)
 		batch_load_buffer_lasers(Batch_buffer, &n_verts);
 		batch_load_buffer_geometry_map_bitmaps(Batch_buffer, &n_verts);
 		batch_load_buffer_distortion_map_bitmaps(Batch_buffer, &n_verts);
-		gr_update_stream_buffer(stream_buffer, Batch_buffer, Batch_buffer_size);
-
 		Assert(n_verts <= n_to_render);
 
+		// only send what was filled in, which is usually well short of the buffer's high water mark
+		gr_update_stream_buffer(stream_buffer, Batch_buffer, n_verts * sizeof(effect_vertex));
+
 		batch_render_lasers(true);
 		batch_render_geometry_map_bitmaps(true);
 		batch_render_distortion_map_bitmaps(true);
@@ -837,6 +854,9 @@ void batch_reset()
 {
 	geometry_map.clear();
 	distortion_map.clear();
+
+	geometry_map_index.clear();
+	distortion_map_index.clear();
 }
 
 void batch_render_close()
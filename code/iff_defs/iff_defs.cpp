@@ -13,12 +13,20 @@
 #include "mission/missionparse.h"
 #include "ship/ship.h"
 #include "io/timer.h"
+#include "globalincs/name_index.h"
 
 extern int radar_target_id_flags;
 
 int Num_iffs;
 iff_info Iff_info[MAX_IFFS];
 
+static name_index Iff_index;
+
+static const char *iff_info_name(int idx)
+{
+	return Iff_info[idx].iff_name;
+}
+
 int Iff_traitor;
 
 int radar_iff_color[5][2][4];
@@ -307,6 +315,7 @@ void iff_init()
 	
 	// begin reading data
 	Num_iffs = 0;
+	iff_lookup_invalidate();
 	while (required_string_either("#End", "$IFF Name:"))
 	{
 		iff_info *iff;
@@ -323,7 +332,6 @@ void iff_init()
 		// add new IFF
 		iff = &Iff_info[Num_iffs];
 		cur_iff = Num_iffs;
-		Num_iffs++;
 
 
 		// get required IFF info ----------------------------------------------
@@ -332,6 +340,9 @@ void iff_init()
 		required_string("$IFF Name:");
 		stuff_string(iff->iff_name, F_NAME, NAME_LENGTH);
 
+		// only count it once it has a name, so that lookups never see it half built
+		Num_iffs++;
+
 		// get the iff color
 		if (check_for_string("$Colour:"))
 			required_string("$Colour:");
@@ -544,11 +555,15 @@ int iff_lookup(char *iff_name)
 	if(iff_name == NULL)
 		return -1;
 
-	for (int i = 0; i < Num_iffs; i++)
-		if (!stricmp(iff_name, Iff_info[i].iff_name))
-			return i;
+	return Iff_index.lookup(iff_name, Num_iffs, iff_info_name);
+}
 
-	return -1;
+/**
+ * Call after renaming Iff_info entries
+ */
+void iff_lookup_invalidate()
+{
+	Iff_index.invalidate();
 }
 
 /**
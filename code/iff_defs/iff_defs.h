@@ -68,6 +68,7 @@ extern void iff_init();
 
 // search for iff
 extern int iff_lookup(char *iff_name);
+extern void iff_lookup_invalidate();
 
 // attack stuff
 // NB: As far as the differences between I attack him and he attacks me, think of a hidden traitor on your own team.
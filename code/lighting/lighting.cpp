@@ -16,6 +16,8 @@
 #include "graphics/2d.h"
 #include "cmdline/cmdline.h"
 
+#include <algorithm>
+
 
 
 #define MAX_LIGHT_LEVELS 16
@@ -33,6 +35,23 @@ int Num_light_levels = 0;
 
 SCP_vector<light*> Static_light;
 
+// Point and tube lights bucketed by the world space grid cells their area of effect overlaps, so that
+// light_filter_push() only has to look at the lights near an object instead of every light in the scene.
+// Built the first time it's needed after the lights change.  Cells are hashed into a fixed number of
+// buckets; lights from other cells that share a bucket are weeded out by the exact test.
+#define LIGHT_GRID_BUCKETS		4096
+#define LIGHT_GRID_MAX_CELLS	64		// lights covering more cells than this are always tested
+#define LIGHT_GRID_MIN_LIGHTS	16		// below this many lights it isn't worth it
+
+static bool Light_grid_dirty = true;
+static float Light_grid_cell_size = 1.0f;
+static int Light_grid_start[LIGHT_GRID_BUCKETS + 1];
+static SCP_vector<int> Light_grid_lights;		// light indices, by bucket
+static SCP_vector<int> Light_grid_always;		// lights that skip the grid
+static int Light_grid_stamp[MAX_LIGHTS];
+static int Light_grid_query = 0;
+static SCP_vector<int> Light_grid_candidates;
+
 static int Light_in_shadow = 0;	// If true, this means we're in a shadow
 
 #define LM_BRIGHTEN  0
@@ -137,6 +156,7 @@ void light_reset()
 	Static_light.clear();
 
 	Num_lights = 0;
+	Light_grid_dirty = true;
 	light_filter_reset();
 }
 extern vec3d Object_position;
@@ -225,6 +245,7 @@ void light_add_directional( vec3d *dir, float intensity, float r, float g, float
 	l->light_ignore_objnum = -1;
 	l->affected_objnum = -1;
 	l->instance = Num_lights-1;
+	Light_grid_dirty = true;
 		
 	Assert( Num_light_levels <= 1 );
 
@@ -275,6 +296,7 @@ void light_add_point( vec3d * pos, float r1, float r2, float intensity, float r,
 	l->light_ignore_objnum = light_ignore_objnum;
 	l->affected_objnum = -1;
 	l->instance = Num_lights-1;
+	Light_grid_dirty = true;
 
 	Assert( Num_light_levels <= 1 );
 }
@@ -317,6 +339,7 @@ void light_add_point_unique( vec3d * pos, float r1, float r2, float intensity, f
 	l->light_ignore_objnum = -1;
 	l->affected_objnum = affected_objnum;
 	l->instance = Num_lights-1;
+	Light_grid_dirty = true;
 
 	Assert( Num_light_levels <= 1 );
 }
@@ -362,6 +385,7 @@ void light_add_tube(vec3d *p0, vec3d *p1, float r1, float r2, float intensity, f
 	l->light_ignore_objnum = Use_GLSL>1 ?affected_objnum : -1;
 	l->affected_objnum = Use_GLSL>1 ? -1 : affected_objnum;
 	l->instance = Num_lights-1;
+	Light_grid_dirty = true;
 
 	Assert( Num_light_levels <= 1 );
 }
@@ -388,6 +412,252 @@ void light_filter_reset()
 }
 
 
+/**
+ * Whether a point or tube light reaches the sphere specified by 'pos' and 'rad' and 'objnum'
+ */
+static bool light_affects_sphere( light *l, int objnum, vec3d *pos, float rad )
+{
+	switch( l->type )	{
+	case LT_DIRECTIONAL:
+		break;
+
+	case LT_POINT:	{
+			// if this is a "unique" light source, it only affects one guy
+			if ( (l->affected_objnum >= 0) && (objnum != l->affected_objnum) )
+				return false;
+
+			vec3d to_light;
+			float dist_squared, max_dist_squared;
+			vm_vec_sub( &to_light, &l->vec, pos );
+			dist_squared = vm_vec_mag_squared(&to_light);
+
+			max_dist_squared = l->radb+rad;
+			max_dist_squared *= max_dist_squared;
+
+			return ( dist_squared < max_dist_squared );
+		}
+
+	// hmm. this could probably be more optimal
+	case LT_TUBE:
+		if(Use_GLSL > 1) {
+			if(l->light_ignore_objnum != objnum){
+				vec3d nearest;
+				float dist_squared, max_dist_squared;
+				vm_vec_dist_squared_to_line(pos,&l->vec,&l->vec2,&nearest,&dist_squared);
+
+				max_dist_squared = l->radb+rad;
+				max_dist_squared *= max_dist_squared;
+
+				return ( dist_squared < max_dist_squared );
+			}
+		}
+		else {
+			// all tubes are "unique" light sources for now
+			return ( (l->affected_objnum >= 0) && (objnum == l->affected_objnum) );
+		}
+		break;
+
+	default:
+		Int3();	// Invalid light type
+	}
+
+	return false;
+}
+
+static inline uint light_grid_bucket( int x, int y, int z )
+{
+	return ( (uint)x * 73856093u ^ (uint)y * 19349663u ^ (uint)z * 83492791u ) % LIGHT_GRID_BUCKETS;
+}
+
+static inline int light_grid_coord( float f )
+{
+	return (int)floor( f / Light_grid_cell_size );
+}
+
+// the range of grid cells covered by a box
+static void light_grid_cells( vec3d *min, vec3d *max, int *lo, int *hi )
+{
+	lo[0] = light_grid_coord(min->xyz.x);
+	lo[1] = light_grid_coord(min->xyz.y);
+	lo[2] = light_grid_coord(min->xyz.z);
+	hi[0] = light_grid_coord(max->xyz.x);
+	hi[1] = light_grid_coord(max->xyz.y);
+	hi[2] = light_grid_coord(max->xyz.z);
+}
+
+// the box around everything a light can reach, or false if it has to be tested against every object
+static bool light_grid_bounds( light *l, vec3d *min, vec3d *max )
+{
+	switch ( l->type ) {
+	case LT_POINT:
+		*min = *max = l->vec;
+		break;
+
+	case LT_TUBE:
+		// without GLSL a tube lights its one object regardless of distance
+		if ( Use_GLSL <= 1 )
+			return false;
+
+		min->xyz.x = MIN(l->vec.xyz.x, l->vec2.xyz.x);
+		min->xyz.y = MIN(l->vec.xyz.y, l->vec2.xyz.y);
+		min->xyz.z = MIN(l->vec.xyz.z, l->vec2.xyz.z);
+		max->xyz.x = MAX(l->vec.xyz.x, l->vec2.xyz.x);
+		max->xyz.y = MAX(l->vec.xyz.y, l->vec2.xyz.y);
+		max->xyz.z = MAX(l->vec.xyz.z, l->vec2.xyz.z);
+		break;
+
+	default:
+		return false;
+	}
+
+	min->xyz.x -= l->radb;
+	min->xyz.y -= l->radb;
+	min->xyz.z -= l->radb;
+	max->xyz.x += l->radb;
+	max->xyz.y += l->radb;
+	max->xyz.z += l->radb;
+
+	return true;
+}
+
+static void light_grid_build()
+{
+	int i, x, y, z;
+	int lo[3], hi[3];
+	vec3d min, max;
+	float total_size = 0.0f;
+	int num_sized = 0;
+
+	Light_grid_dirty = false;
+	Light_grid_always.clear();
+	Light_grid_lights.clear();
+	memset( Light_grid_start, 0, sizeof(Light_grid_start) );
+
+	// make the cells about as big as the average light
+	for (i=0; i<Num_lights; i++ )	{
+		if ( Lights[i].type == LT_POINT ) {
+			total_size += 2.0f * Lights[i].radb;
+			num_sized++;
+		}
+	}
+
+	Light_grid_cell_size = (num_sized > 0) ? MAX(total_size / num_sized, 1.0f) : 1000.0f;
+
+	// count the lights in each bucket, then lay them out
+	for (int pass = 0; pass < 2; pass++) {
+		for (i=0; i<Num_lights; i++ )	{
+			light *l = &Lights[i];
+
+			if ( l->type == LT_DIRECTIONAL )
+				continue;
+
+			bool in_grid = light_grid_bounds(l, &min, &max);
+			float cells = 0.0f;
+
+			if ( in_grid ) {
+				light_grid_cells( &min, &max, lo, hi );
+				cells = (float)(hi[0] - lo[0] + 1) * (float)(hi[1] - lo[1] + 1) * (float)(hi[2] - lo[2] + 1);
+			}
+
+			if ( !in_grid || (cells > LIGHT_GRID_MAX_CELLS) ) {
+				if ( pass == 0 )
+					Light_grid_always.push_back(i);
+				continue;
+			}
+
+			for (x = lo[0]; x <= hi[0]; x++) {
+				for (y = lo[1]; y <= hi[1]; y++) {
+					for (z = lo[2]; z <= hi[2]; z++) {
+						uint bucket = light_grid_bucket(x, y, z);
+
+						if ( pass == 0 )
+							Light_grid_start[bucket + 1]++;
+						else
+							Light_grid_lights[Light_grid_start[bucket]++] = i;
+					}
+				}
+			}
+		}
+
+		if ( pass == 0 ) {
+			for (i = 0; i < LIGHT_GRID_BUCKETS; i++)
+				Light_grid_start[i + 1] += Light_grid_start[i];
+
+			Light_grid_lights.resize(Light_grid_start[LIGHT_GRID_BUCKETS]);
+		}
+	}
+
+	// filling in moved every start up to the next bucket's, so shift them back
+	for (i = LIGHT_GRID_BUCKETS; i > 0; i--)
+		Light_grid_start[i] = Light_grid_start[i - 1];
+	Light_grid_start[0] = 0;
+}
+
+// collects the lights whose grid cells overlap the sphere, in the order they were added
+static void light_grid_gather( vec3d *pos, float rad )
+{
+	int i, x, y, z;
+	int lo[3], hi[3];
+	vec3d min, max;
+
+	if ( Light_grid_dirty )
+		light_grid_build();
+
+	Light_grid_candidates.clear();
+
+	// a new stamp marks every light as not seen yet
+	if ( ++Light_grid_query <= 0 ) {
+		memset( Light_grid_stamp, 0, sizeof(Light_grid_stamp) );
+		Light_grid_query = 1;
+	}
+
+	for (i = 0; i < (int)Light_grid_always.size(); i++) {
+		Light_grid_stamp[Light_grid_always[i]] = Light_grid_query;
+		Light_grid_candidates.push_back(Light_grid_always[i]);
+	}
+
+	min = max = *pos;
+	min.xyz.x -= rad;
+	min.xyz.y -= rad;
+	min.xyz.z -= rad;
+	max.xyz.x += rad;
+	max.xyz.y += rad;
+	max.xyz.z += rad;
+
+	light_grid_cells( &min, &max, lo, hi );
+
+	// a huge object just looks at everything
+	float cells = (float)(hi[0] - lo[0] + 1) * (float)(hi[1] - lo[1] + 1) * (float)(hi[2] - lo[2] + 1);
+
+	if ( cells > LIGHT_GRID_MAX_CELLS ) {
+		Light_grid_candidates.clear();
+
+		for (i = 0; i < Num_lights; i++)
+			Light_grid_candidates.push_back(i);
+
+		return;
+	}
+
+	for (x = lo[0]; x <= hi[0]; x++) {
+		for (y = lo[1]; y <= hi[1]; y++) {
+			for (z = lo[2]; z <= hi[2]; z++) {
+				uint bucket = light_grid_bucket(x, y, z);
+
+				for (i = Light_grid_start[bucket]; i < Light_grid_start[bucket + 1]; i++) {
+					int idx = Light_grid_lights[i];
+
+					if ( Light_grid_stamp[idx] != Light_grid_query ) {
+						Light_grid_stamp[idx] = Light_grid_query;
+						Light_grid_candidates.push_back(idx);
+					}
+				}
+			}
+		}
+	}
+
+	std::sort( Light_grid_candidates.begin(), Light_grid_candidates.end() );
+}
+
 /**
  * Makes a list of only the lights that will affect
  * the sphere specified by 'pos' and 'rad' and 'objnum'
@@ -413,73 +683,25 @@ int light_filter_push( int objnum, vec3d *pos, float rad )
 
 	Num_relevent_lights[n2] = 0;
 
-	for (i=0; i<Num_relevent_lights[n1]; i++ )	{
-		l = Relevent_lights[i][n1];
+	// the lights at the first level are all of them, so only the ones near the object need checking
+	if ( Num_lights >= LIGHT_GRID_MIN_LIGHTS ) {
+		light_grid_gather( pos, rad );
 
-		switch( l->type )	{
-		case LT_DIRECTIONAL:
-			//Relevent_lights[Num_relevent_lights[n2]++][n2] = l;
-			break;
+		for (i=0; i<(int)Light_grid_candidates.size(); i++ )	{
+			l = &Lights[Light_grid_candidates[i]];
 
-		case LT_POINT:	{
-				// if this is a "unique" light source, it only affects one guy
-				if(l->affected_objnum >= 0){
-					if(objnum == l->affected_objnum){
-						vec3d to_light;
-						float dist_squared, max_dist_squared;
-						vm_vec_sub( &to_light, &l->vec, pos );
-						dist_squared = vm_vec_mag_squared(&to_light);
-
-						max_dist_squared = l->radb+rad;
-						max_dist_squared *= max_dist_squared;
-						
-						if ( dist_squared < max_dist_squared )	{
-							Relevent_lights[Num_relevent_lights[n2]++][n2] = l;
-						}
-					}
-				}
-				// otherwise check all relevant objects
-				else {
-                    vec3d to_light;
-                    float dist_squared, max_dist_squared;
-                    vm_vec_sub( &to_light, &l->vec, pos );
-                    dist_squared = vm_vec_mag_squared(&to_light);
-
-                    max_dist_squared = l->radb+rad;
-                    max_dist_squared *= max_dist_squared;
-						
-                    if ( dist_squared < max_dist_squared )	{
-                        Relevent_lights[Num_relevent_lights[n2]++][n2] = l;
-                    }
-				}
-			}
-			break;
+			if ( light_affects_sphere(l, objnum, pos, rad) )
+				Relevent_lights[Num_relevent_lights[n2]++][n2] = l;
+		}
 
-		// hmm. this could probably be more optimal
-		case LT_TUBE:
-			if(Use_GLSL > 1) {
-				if(l->light_ignore_objnum != objnum){
-					vec3d nearest;
-					float dist_squared, max_dist_squared;
-					vm_vec_dist_squared_to_line(pos,&l->vec,&l->vec2,&nearest,&dist_squared);
-
-					max_dist_squared = l->radb+rad;
-					max_dist_squared *= max_dist_squared;
-					
-					if ( dist_squared < max_dist_squared )
-						Relevent_lights[Num_relevent_lights[n2]++][n2] = l;
-				}
- 			}
-			else {
- 				// all tubes are "unique" light sources for now
-				if((l->affected_objnum >= 0) && (objnum == l->affected_objnum))
-					Relevent_lights[Num_relevent_lights[n2]++][n2] = l;
-			}
-			break;
+		return Num_relevent_lights[n2];
+	}
 
-		default:
-			Int3();	// Invalid light type
-		}
+	for (i=0; i<Num_relevent_lights[n1]; i++ )	{
+		l = Relevent_lights[i][n1];
+
+		if ( light_affects_sphere(l, objnum, pos, rad) )
+			Relevent_lights[Num_relevent_lights[n2]++][n2] = l;
 	}
 
 	return Num_relevent_lights[n2];
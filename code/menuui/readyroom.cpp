@@ -488,6 +488,7 @@ int build_standalone_mission_list_do_frame()
 
 	if (Num_standalone_missions_with_info == Num_standalone_missions) {
 		Standalone_mission_names_inited = 1;
+		mission_header_index_save();
 		return 1;
 	} else {
 		return 0;
@@ -548,6 +549,7 @@ int build_campaign_mission_list_do_frame()
 	if (Num_campaign_missions_with_info == Campaign.num_missions) {
 		valid_missions_with_info = 0;
 		Campaign_mission_names_inited = 1;
+		mission_header_index_save();
 		return 1;
 	} else {
 		return 0;
@@ -1087,6 +1089,8 @@ void sim_room_init()
 	Ui_window.draw();
 	gr_flip();		
 
+	mission_header_index_rescan();
+
 	Get_file_list_filter = sim_room_standalone_mission_filter;
 	memset(wild_card, 0, 256);
 	strcpy_s(wild_card, NOX("*"));
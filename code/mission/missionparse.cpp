@@ -136,6 +136,7 @@ int Subsys_index;
 int Subsys_status_size;
 
 char Mission_parse_storm_name[NAME_LENGTH] = "none";
+static bool Mission_parse_found_storm = false;		// whether the last mission info parsed had a storm name
 
 team_data Team_data[MAX_TVT_TEAMS];
 
@@ -481,8 +482,10 @@ void parse_mission_info(mission *pm, bool basic = false)
 	if(optional_string("+NebAwacs:")){
 		stuff_float(&Neb2_awacs);
 	}
+	Mission_parse_found_storm = false;
 	if(optional_string("+Storm:")){
 		stuff_string(Mission_parse_storm_name, F_NAME, NAME_LENGTH);
+		Mission_parse_found_storm = true;
 
 		if (!basic)
 			nebl_set_storm(Mission_parse_storm_name);
@@ -5783,6 +5786,312 @@ void post_process_mission()
 	Last_file_checksum = Current_file_checksum;
 }
 
+// Mission header index.  Building the mission lists needs only the header of each
+// mission, but getting it means reading and comment-stripping every whole file, which
+// gets slow with big mission directories.  The header fields are kept in the cache
+// directory instead, keyed by file name, and are reused for as long as the size and
+// write time reported for the file stay the same.  The names and descriptions are stored
+// already translated, so the index only holds missions for the language it was built in.
+#define MISSION_HEADER_INDEX_FILE		"missions.hdx"
+#define MISSION_HEADER_INDEX_ID			0x58444820	// "HDX " - ("  XDH" in file)
+#define MISSION_HEADER_INDEX_VERSION	2
+
+typedef struct mission_header_info {
+	int		size;
+	int		write_time;
+	int		rval;				// result of the parse, headers are only filled in if this is 0
+	float	version;
+	SCP_string name;
+	SCP_string author;
+	SCP_string created;
+	SCP_string modified;
+	SCP_string notes;
+	SCP_string mission_desc;
+	int		game_type;
+	int		flags;
+	int		num_players;
+	uint	num_respawns;
+	int		max_respawn_delay;
+	int		contrail_threshold;
+
+	// globals a basic parse also sets
+	float	neb2_awacs;
+	bool	has_storm;
+	SCP_string storm_name;
+	float	fog_near_mult;
+	float	fog_far_mult;
+} mission_header_info;
+
+static SCP_map<SCP_string, mission_header_info> Mission_header_index;
+static SCP_map<SCP_string, int> Mission_header_write_times;		// from the last file listing
+static bool Mission_header_index_loaded = false;
+static bool Mission_header_index_dirty = false;
+static int Mission_header_index_lang = -1;						// language the index was loaded for
+
+static void mission_header_index_key(const char *filename, SCP_string &key)
+{
+	key = filename;
+	for (SCP_string::iterator ii = key.begin(); ii != key.end(); ++ii)
+		*ii = (char)tolower(*ii);
+}
+
+static void mission_header_index_load()
+{
+	Mission_header_index_loaded = true;
+	Mission_header_index_lang = lcl_get_language();
+	Mission_header_index.clear();
+
+	CFILE *cfp = cfopen(MISSION_HEADER_INDEX_FILE, "rb", CFILE_NORMAL, CF_TYPE_CACHE);
+	if (cfp == NULL)
+		return;
+
+	if ( (cfilelength(cfp) < 4 * (int)sizeof(int)) || (cfread_int(cfp) != MISSION_HEADER_INDEX_ID) || (cfread_int(cfp) != MISSION_HEADER_INDEX_VERSION) ) {
+		mprintf(("MISSIONS: Ignoring out of date mission header index\n"));
+		cfclose(cfp);
+		return;
+	}
+
+	if (cfread_int(cfp) != Mission_header_index_lang) {
+		mprintf(("MISSIONS: Ignoring mission header index built for another language\n"));
+		cfclose(cfp);
+		return;
+	}
+
+	char buf[NOTES_LENGTH];
+	int count = cfread_int(cfp);
+
+	for (int i = 0; i < count && !cfeof(cfp); i++) {
+		mission_header_info mhi;
+
+		cfread_string_len(buf, MAX_FILENAME_LEN, cfp);
+		SCP_string key = buf;
+
+		mhi.size = cfread_int(cfp);
+		mhi.write_time = cfread_int(cfp);
+		mhi.rval = cfread_int(cfp);
+		mhi.version = cfread_float(cfp);
+		cfread_string_len(buf, NAME_LENGTH, cfp);
+		mhi.name = buf;
+		cfread_string_len(buf, NAME_LENGTH, cfp);
+		mhi.author = buf;
+		cfread_string_len(buf, DATE_TIME_LENGTH, cfp);
+		mhi.created = buf;
+		cfread_string_len(buf, DATE_TIME_LENGTH, cfp);
+		mhi.modified = buf;
+		cfread_string_len(buf, NOTES_LENGTH, cfp);
+		mhi.notes = buf;
+		cfread_string_len(buf, MISSION_DESC_LENGTH, cfp);
+		mhi.mission_desc = buf;
+		mhi.game_type = cfread_int(cfp);
+		mhi.flags = cfread_int(cfp);
+		mhi.num_players = cfread_int(cfp);
+		mhi.num_respawns = cfread_uint(cfp);
+		mhi.max_respawn_delay = cfread_int(cfp);
+		mhi.contrail_threshold = cfread_int(cfp);
+		mhi.neb2_awacs = cfread_float(cfp);
+		mhi.has_storm = (cfread_int(cfp) != 0);
+		cfread_string_len(buf, NAME_LENGTH, cfp);
+		mhi.storm_name = buf;
+		mhi.fog_near_mult = cfread_float(cfp);
+		mhi.fog_far_mult = cfread_float(cfp);
+
+		Mission_header_index[key] = mhi;
+	}
+
+	cfclose(cfp);
+}
+
+/**
+ * Writes the mission header index back to the cache directory if anything was added to it.
+ */
+void mission_header_index_save()
+{
+	if (!Mission_header_index_dirty)
+		return;
+
+	CFILE *cfp = cfopen(MISSION_HEADER_INDEX_FILE, "wb", CFILE_NORMAL, CF_TYPE_CACHE);
+	if (cfp == NULL)
+		return;
+
+	cfwrite_int(MISSION_HEADER_INDEX_ID, cfp);
+	cfwrite_int(MISSION_HEADER_INDEX_VERSION, cfp);
+	cfwrite_int(Mission_header_index_lang, cfp);
+	cfwrite_int((int)Mission_header_index.size(), cfp);
+
+	for (SCP_map<SCP_string, mission_header_info>::iterator ii = Mission_header_index.begin(); ii != Mission_header_index.end(); ++ii) {
+		mission_header_info *mhi = &ii->second;
+
+		cfwrite_string_len(ii->first.c_str(), cfp);
+		cfwrite_int(mhi->size, cfp);
+		cfwrite_int(mhi->write_time, cfp);
+		cfwrite_int(mhi->rval, cfp);
+		cfwrite_float(mhi->version, cfp);
+		cfwrite_string_len(mhi->name.c_str(), cfp);
+		cfwrite_string_len(mhi->author.c_str(), cfp);
+		cfwrite_string_len(mhi->created.c_str(), cfp);
+		cfwrite_string_len(mhi->modified.c_str(), cfp);
+		cfwrite_string_len(mhi->notes.c_str(), cfp);
+		cfwrite_string_len(mhi->mission_desc.c_str(), cfp);
+		cfwrite_int(mhi->game_type, cfp);
+		cfwrite_int(mhi->flags, cfp);
+		cfwrite_int(mhi->num_players, cfp);
+		cfwrite_uint(mhi->num_respawns, cfp);
+		cfwrite_int(mhi->max_respawn_delay, cfp);
+		cfwrite_int(mhi->contrail_threshold, cfp);
+		cfwrite_float(mhi->neb2_awacs, cfp);
+		cfwrite_int(mhi->has_storm ? 1 : 0, cfp);
+		cfwrite_string_len(mhi->storm_name.c_str(), cfp);
+		cfwrite_float(mhi->fog_near_mult, cfp);
+		cfwrite_float(mhi->fog_far_mult, cfp);
+	}
+
+	cfclose(cfp);
+	Mission_header_index_dirty = false;
+}
+
+/**
+ * Forget the file times from the previous listing so that the next lookup picks up
+ * missions that were added or changed since.  Call before (re)building a mission list.
+ */
+void mission_header_index_rescan()
+{
+	Mission_header_write_times.clear();
+}
+
+static void mission_header_index_list_files()
+{
+	SCP_vector<SCP_string> files;
+	SCP_vector<file_list_info> info;
+	SCP_string key;
+
+	// this can be reached from inside a filtered listing (the ready room filters its mission
+	// list with mission_parse_is_multi()), so don't let this listing use or reset that filter
+	int (*saved_filter)(const char *filename) = Get_file_list_filter;
+	const char *saved_child = Get_file_list_child;
+	Get_file_list_filter = NULL;
+	Get_file_list_child = NULL;
+
+	Mission_header_write_times.clear();
+	cf_get_file_list(files, CF_TYPE_MISSIONS, NOX("*" FS_MISSION_FILE_EXT), CF_SORT_NONE, &info);
+
+	Get_file_list_filter = saved_filter;
+	Get_file_list_child = saved_child;
+
+	for (size_t i = 0; i < files.size() && i < info.size(); i++) {
+		mission_header_index_key(cf_add_ext(files[i].c_str(), FS_MISSION_FILE_EXT), key);
+		Mission_header_write_times[key] = (int)info[i].write_time;
+	}
+}
+
+// find the size and write time of the mission file that would be loaded right now
+static bool mission_header_index_stat(const char *filename, const SCP_string &key, int *size, int *write_time)
+{
+	int offset;
+
+	if ( !cf_find_file_location(filename, CF_TYPE_MISSIONS, 0, NULL, size, &offset) )
+		return false;
+
+	if (Mission_header_write_times.empty())
+		mission_header_index_list_files();
+
+	SCP_map<SCP_string, int>::iterator ii = Mission_header_write_times.find(key);
+	if (ii == Mission_header_write_times.end())
+		return false;
+
+	*write_time = ii->second;
+	return true;
+}
+
+static void mission_header_index_store(const SCP_string &key, int size, int write_time, int rval, mission *pm, bool has_storm)
+{
+	mission_header_info mhi;
+
+	mhi.size = size;
+	mhi.write_time = write_time;
+	mhi.rval = rval;
+	mhi.version = pm->version;
+	mhi.name = pm->name;
+	mhi.author = pm->author;
+	mhi.created = pm->created;
+	mhi.modified = pm->modified;
+	mhi.notes = pm->notes;
+	mhi.mission_desc = pm->mission_desc;
+	mhi.game_type = pm->game_type;
+	mhi.flags = pm->flags;
+	mhi.num_players = pm->num_players;
+	mhi.num_respawns = pm->num_respawns;
+	mhi.max_respawn_delay = The_mission.max_respawn_delay;	// parse_mission_info() always puts it here
+	mhi.contrail_threshold = pm->contrail_threshold;
+	mhi.neb2_awacs = Neb2_awacs;
+	mhi.has_storm = has_storm;
+	mhi.storm_name = has_storm ? Mission_parse_storm_name : "";
+	mhi.fog_near_mult = Neb2_fog_near_mult;
+	mhi.fog_far_mult = Neb2_fog_far_mult;
+
+	Mission_header_index[key] = mhi;
+	Mission_header_index_dirty = true;
+}
+
+static void mission_header_index_fetch(mission_header_info *mhi, mission *pm)
+{
+	pm->Reset();
+	pm->version = mhi->version;
+	strcpy_s(pm->name, mhi->name.c_str());
+	strcpy_s(pm->author, mhi->author.c_str());
+	strcpy_s(pm->created, mhi->created.c_str());
+	strcpy_s(pm->modified, mhi->modified.c_str());
+	strcpy_s(pm->notes, mhi->notes.c_str());
+	strcpy_s(pm->mission_desc, mhi->mission_desc.c_str());
+	pm->game_type = mhi->game_type;
+	pm->flags = mhi->flags;
+	pm->num_players = mhi->num_players;
+	pm->num_respawns = mhi->num_respawns;
+	The_mission.max_respawn_delay = mhi->max_respawn_delay;
+	pm->contrail_threshold = mhi->contrail_threshold;
+
+	// the same globals parse_mission_info() sets before it stops for a basic parse
+	Neb2_awacs = mhi->neb2_awacs;
+	if (mhi->has_storm)
+		strcpy_s(Mission_parse_storm_name, mhi->storm_name.c_str());
+	Neb2_fog_near_mult = mhi->fog_near_mult;
+	Neb2_fog_far_mult = mhi->fog_far_mult;
+	red_alert_invalidate_timestamp();
+}
+
+// Looks a mission file up in the header index, loading the index first if need be.  Returns the entry if
+// it is still current for the file, otherwise NULL.  key, size and write_time are what a new entry for the
+// file should be stored with; key is left empty if the file can't be indexed.
+static mission_header_info *mission_header_index_find(const char *filename, SCP_string &key, int *size, int *write_time)
+{
+	key.clear();
+
+	if (Fred_running)
+		return NULL;
+
+	// the language changed, so everything in the index is in the wrong one
+	if (Mission_header_index_loaded && (Mission_header_index_lang != lcl_get_language())) {
+		mission_header_index_save();
+		Mission_header_index_loaded = false;
+	}
+
+	if (!Mission_header_index_loaded)
+		mission_header_index_load();
+
+	mission_header_index_key(filename, key);
+
+	if ( !mission_header_index_stat(filename, key, size, write_time) ) {
+		key.clear();
+		return NULL;
+	}
+
+	SCP_map<SCP_string, mission_header_info>::iterator ii = Mission_header_index.find(key);
+
+	if ( (ii == Mission_header_index.end()) || (ii->second.size != *size) || (ii->second.write_time != *write_time) )
+		return NULL;
+
+	return &ii->second;
+}
+
 int get_mission_info(const char *filename, mission *mission_p, bool basic)
 {
 	char real_fname[MAX_FILENAME_LEN];
@@ -5800,6 +6109,21 @@ int get_mission_info(const char *filename, mission *mission_p, bool basic)
 	if ( mission_p == NULL )
 		mission_p = &The_mission;
 
+	// the header index only holds what a basic parse fills in
+	SCP_string key;
+	int size = 0, write_time = 0;
+
+	if (basic) {
+		mission_header_info *mhi = mission_header_index_find(real_fname, key, &size, &write_time);
+
+		if (mhi != NULL) {
+			if (mhi->rval == 0)
+				mission_header_index_fetch(mhi, mission_p);
+
+			return mhi->rval;
+		}
+	}
+
 	// open localization
 	lcl_ext_open();
 
@@ -5832,6 +6156,9 @@ int get_mission_info(const char *filename, mission *mission_p, bool basic)
 	// close localization
 	lcl_ext_close();
 
+	if (!key.empty())
+		mission_header_index_store(key, size, write_time, rval, mission_p, Mission_parse_found_storm);
+
 	return rval;
 }
 
@@ -5927,6 +6254,8 @@ int parse_main(const char *mission_name, int flags)
 // Note, this is currently only called from game_shutdown()
 void mission_parse_close()
 {
+	mission_header_index_save();
+
 	// free subsystems
 	if (Subsys_status != NULL)
 	{
@@ -6260,6 +6589,29 @@ int mission_parse_is_multi(const char *filename, char *mission_name)
 	int rval, game_type;
 	int filelength;
 	CFILE *ftemp;
+	char real_fname[MAX_FILENAME_LEN];
+	SCP_string key;
+	int size = 0, write_time = 0;
+
+	// the header index has the name and game type, and reading them from it doesn't touch any of the
+	// globals a parse would set
+	strncpy(real_fname, filename, MAX_FILENAME_LEN-1);
+	real_fname[sizeof(real_fname)-1] = '\0';
+
+	char *p = strrchr(real_fname, '.');
+	if (p) *p = 0; // remove any extension
+	strcat_s(real_fname, FS_MISSION_FILE_EXT);  // append mission extension
+
+	mission_header_info *mhi = mission_header_index_find(real_fname, key, &size, &write_time);
+
+	if (mhi != NULL) {
+		if (mhi->rval != 0)
+			return 0;
+
+		strcpy(mission_name, mhi->name.c_str());
+
+		return (mhi->game_type & MISSION_TYPE_MULTI) ? mhi->game_type : 0;
+	}
 
 	// new way of getting information.  Open the file, and just get the name and the game_type flags.
 	// return the flags if a multiplayer mission
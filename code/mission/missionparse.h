@@ -636,6 +636,10 @@ int is_training_mission();
 // code to save/restore mission parse stuff
 int get_mission_info(const char *filename, mission *missionp = NULL, bool basic = true);
 
+// cached mission headers for building mission lists
+void mission_header_index_rescan();
+void mission_header_index_save();
+
 // Goober5000
 void parse_dock_one_docked_object(p_object *pobjp, p_object *parent_pobjp);
 
@@ -89,6 +89,14 @@ typedef struct submodel_instance {
 	matrix mc_orient;
 	bool collision_checked;
 	bool blown_off;
+
+	// cached transforms, kept up to date by model_instance_get_transform()
+	angles xform_angs;				// the angs that local_orient was built from
+	matrix local_orient;			// rotation relative to the parent submodel
+	matrix model_orient;			// orientation in the model's frame of reference
+	vec3d model_pos;				// position of the origin in the model's frame of reference
+	uint xform_stamp;				// changes whenever model_orient/model_pos are rebuilt, 0 if never built
+	uint parent_xform_stamp;		// the parent's xform_stamp at that time
 } submodel_instance;
 
 // Data specific to a particular instance of a model.
@@ -96,6 +104,7 @@ typedef struct polymodel_instance {
 	int model_num;					// global model num index, same as polymodel->id
 	int root_submodel_num;			// unused?
 	submodel_instance *submodel;	// array of submodel instances; mirrors the polymodel->submodel array
+	uint xform_counter;				// source of submodel_instance::xform_stamp
 } polymodel_instance;
 
 #define MAX_MODEL_SUBSYSTEMS		200				// used in ships.cpp (only place?) for local stack variable DTP; bumped to 200
@@ -300,6 +309,15 @@ struct bsp_collision_tree {
 	bool used;
 };
 
+// The lists of a bsp_collision_tree while it's being built.  These use the plain std allocator rather than
+// vm_malloc, whose debug bookkeeping isn't thread safe, so the BSP data can be parsed on a worker thread.
+struct bsp_collision_buffers {
+	std::vector<vec3d> point_list;
+	std::vector<bsp_collision_node> node_list;
+	std::vector<bsp_collision_leaf> leaf_list;
+	std::vector<model_tmap_vert> vert_list;
+};
+
 class bsp_info
 {
 public:
@@ -966,6 +984,16 @@ extern void model_set_instance_techroom(int model_num, int sub_model_num, float
 void model_update_instance(int model_instance_num, int sub_model_num, submodel_instance_info *sii);
 void model_instance_dumb_rotation(int model_instance_num);
 
+// Brings the cached transforms of a submodel instance and all of its parents up to date and returns it.  Only the
+// submodels whose angles, or whose parents' angles, changed since the last call are rebuilt.  A point p in the
+// submodel's frame of reference is at model_pos + unrotate(p, model_orient) in the model's.
+submodel_instance *model_instance_get_transform(polymodel *pm, polymodel_instance *pmi, int submodel_num);
+
+// Brings the cached transforms of every submodel of a model instance up to date.  Once this has been called,
+// model_instance_get_transform() only reads the cache until the instance's angles change again, so the collider
+// threads can use it.
+void model_instance_update_transforms(int model_instance_num);
+
 // Adds an electrical arcing effect to a submodel
 void model_add_arc(int model_num, int sub_model_num, vec3d *v1, vec3d *v2, int arc_type);
 
@@ -1114,6 +1142,8 @@ inline void mc_info_init(mc_info *mc)
 
 int model_collide(mc_info * mc_info);
 void model_collide_parse_bsp(bsp_collision_tree *tree, void *model_ptr, int version);
+void model_collide_parse_bsp_buffers(bsp_collision_buffers *buffers, void *model_ptr, int version);
+void model_collide_fill_bsp_tree(bsp_collision_tree *tree, bsp_collision_buffers *buffers);
 
 bsp_collision_tree *model_get_bsp_collision_tree(int tree_index);
 void model_remove_bsp_collision_tree(int tree_index);
@@ -1200,29 +1230,6 @@ typedef struct mst_info {
 } mst_info;
 
 
-//Valathil - Buffer struct for transparent object sorting
-typedef struct transparent_object {
-	int blend_filter;
-	float alpha;
-	int texture;
-	int glow_map;
-	int spec_map;
-	int norm_map;
-	int height_map;
-	int misc_map;
-	vertex_buffer *buffer;
-	unsigned int tmap_flags;
-	int i;
-	vec3d scale;
-} transparent_object;
-
-typedef struct transparent_submodel {
-	bsp_info *model;
-	matrix orient;
-	bool is_submodel;
-	bool pop_matrix;
-	SCP_vector<transparent_object> transparent_objects;
-} transparent_submodel;
 // scale the engines thrusters by this much
 // Only enabled if MR_SHOW_THRUSTERS is on
 void model_set_thrust(int model_num = -1, mst_info *mst = NULL);
@@ -1265,6 +1272,9 @@ float get_world_closest_box_point_with_delta(vec3d *closest_box_point, object *b
 // given a newly loaded model, page in all textures
 void model_page_in_textures(int modelnum, int ship_info_index = -1);
 
+// builds any collision trees held back while paging in a level; called by model_page_in_stop()
+void model_finish_deferred_loads();
+
 // given a model, unload all of its textures
 void model_page_out_textures(int model_num, bool release = false);
 
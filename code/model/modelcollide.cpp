@@ -347,28 +347,6 @@ inline void model_collide_defpoints(model_collision * MC_struct_ptr, ubyte * p)
 	} 
 }
 
-inline int model_collide_parse_bsp_defpoints(model_collision * MC_struct_ptr, ubyte * p)
-{
-	int n;
-	int nverts = w(p+8);	
-	int offset = w(p+16);
-
-	ubyte * normcount = p+20;
-	vec3d *src = vp(p+offset);
-
-//	Assert( MC_struct_ptr->MC_point_list != NULL );
-	MC_struct_ptr->MC_point_list.clear();
-
-	for (n=0; n<nverts; n++ ) {
-//		MC_struct_ptr->MC_point_list[n] = src;
-		MC_struct_ptr->MC_point_list.push_back(src);
-
-		src += normcount[n]+1;
-	}
-
-	return nverts;
-}
-
 // Flat Poly
 // +0      int         id
 // +4      int         size 
@@ -620,7 +598,7 @@ inline void model_collide_bsp(model_collision * MC_struct_ptr, bsp_collision_tre
 	}
 }
 
-inline void model_collide_parse_bsp_tmappoly(bsp_collision_leaf *leaf, SCP_vector<model_tmap_vert> *vert_buffer, void *model_ptr)
+inline void model_collide_parse_bsp_tmappoly(bsp_collision_leaf *leaf, std::vector<model_tmap_vert> *vert_buffer, void *model_ptr)
 {
 	ubyte *p = (ubyte *)model_ptr;
 
@@ -660,7 +638,7 @@ inline void model_collide_parse_bsp_tmappoly(bsp_collision_leaf *leaf, SCP_vecto
 	}
 }
 
-inline void model_collide_parse_bsp_flatpoly(bsp_collision_leaf *leaf, SCP_vector<model_tmap_vert> *vert_buffer, void *model_ptr)
+inline void model_collide_parse_bsp_flatpoly(bsp_collision_leaf *leaf, std::vector<model_tmap_vert> *vert_buffer, void *model_ptr)
 {
 	ubyte *p = (ubyte *)model_ptr;
 
@@ -703,7 +681,8 @@ inline void model_collide_parse_bsp_flatpoly(bsp_collision_leaf *leaf, SCP_vecto
 	}
 }
 
-void model_collide_parse_bsp(bsp_collision_tree *tree, void *model_ptr, int version)
+// Parses the BSP data into buffers, without touching vm_malloc.  Safe to run on a worker thread.
+void model_collide_parse_bsp_buffers(bsp_collision_buffers *buffers, void *model_ptr, int version)
 {
 	ubyte *p = (ubyte *)model_ptr;
 	ubyte *next_p;
@@ -714,26 +693,26 @@ void model_collide_parse_bsp(bsp_collision_tree *tree, void *model_ptr, int vers
 	int next_chunk_type;
 	int next_chunk_size;
 
-	model_collision MC_struct;
-
 	Assert(chunk_type == OP_DEFPOINTS);
 
-	int n_verts = model_collide_parse_bsp_defpoints(&MC_struct, p);
+	buffers->point_list.clear();
+	buffers->node_list.clear();
+	buffers->leaf_list.clear();
+	buffers->vert_list.clear();
 
-	if ( n_verts <= 0) {
-		tree->point_list = NULL;
-		tree->n_verts = 0;
-
-		tree->n_nodes = 0;
-		tree->node_list = NULL;
+	// the points, each one followed by its normals
+	int n_verts = w(p+8);
+	ubyte *normcount = p+20;
+	vec3d *src = vp(p+w(p+16));
 
-		tree->n_leaves = 0;
-		tree->leaf_list = NULL;
+	if ( n_verts <= 0 )
+		return;
 
-		// finally copy the vert list.
-		tree->vert_list = NULL;
+	buffers->point_list.reserve(n_verts);
 
-		return;
+	for (int n = 0; n < n_verts; n++) {
+		buffers->point_list.push_back(*src);
+		src += normcount[n]+1;
 	}
 
 	p += chunk_size;
@@ -741,11 +720,11 @@ void model_collide_parse_bsp(bsp_collision_tree *tree, void *model_ptr, int vers
 	bsp_collision_node new_node;
 	bsp_collision_leaf new_leaf;
 
-	SCP_vector<bsp_collision_node> node_buffer;
-	SCP_vector<bsp_collision_leaf> leaf_buffer;
-	SCP_vector<model_tmap_vert> vert_buffer;
+	std::vector<bsp_collision_node> &node_buffer = buffers->node_list;
+	std::vector<bsp_collision_leaf> &leaf_buffer = buffers->leaf_list;
+	std::vector<model_tmap_vert> &vert_buffer = buffers->vert_list;
 
-	SCP_map<size_t, ubyte*> bsp_datap;
+	std::map<size_t, ubyte*> bsp_datap;
 
 	node_buffer.push_back(new_node);
 
@@ -854,34 +833,65 @@ void model_collide_parse_bsp(bsp_collision_tree *tree, void *model_ptr, int vers
 			break;
 		}
 	}
+}
 
-	// copy point list
-	Assert(n_verts != -1);
+// Copies parsed buffers into the tree's vm_malloc'd lists and empties them.  Main thread only.
+void model_collide_fill_bsp_tree(bsp_collision_tree *tree, bsp_collision_buffers *buffers)
+{
+	int n_verts = (int)buffers->point_list.size();
 
-	tree->point_list = (vec3d*)vm_malloc(sizeof(vec3d) * n_verts);
+	if ( n_verts <= 0) {
+		tree->point_list = NULL;
+		tree->n_verts = 0;
+
+		tree->n_nodes = 0;
+		tree->node_list = NULL;
+
+		tree->n_leaves = 0;
+		tree->leaf_list = NULL;
+
+		// finally copy the vert list.
+		tree->vert_list = NULL;
 
-	for ( i = 0; i < (size_t)n_verts; ++i ) {
-		tree->point_list[i] = *MC_struct.MC_point_list[i];
+		return;
 	}
 
+	// copy point list
+	tree->point_list = (vec3d*)vm_malloc(sizeof(vec3d) * n_verts);
+	memcpy(tree->point_list, &buffers->point_list[0], sizeof(vec3d) * n_verts);
+
 	tree->n_verts = n_verts;
 
 	// copy node info. this might be a good time to organize the nodes into a cache efficient tree layout.
-	tree->n_nodes = node_buffer.size();
-	tree->node_list = (bsp_collision_node*)vm_malloc(sizeof(bsp_collision_node) * node_buffer.size());
-	memcpy(tree->node_list, &node_buffer[0], sizeof(bsp_collision_node) * node_buffer.size());
-	node_buffer.clear();
+	tree->n_nodes = buffers->node_list.size();
+	tree->node_list = (bsp_collision_node*)vm_malloc(sizeof(bsp_collision_node) * buffers->node_list.size());
+	if ( !buffers->node_list.empty() )
+		memcpy(tree->node_list, &buffers->node_list[0], sizeof(bsp_collision_node) * buffers->node_list.size());
 
 	// copy leaves.
-	tree->n_leaves = leaf_buffer.size();
-	tree->leaf_list = (bsp_collision_leaf*)vm_malloc(sizeof(bsp_collision_leaf) * leaf_buffer.size());
-	memcpy(tree->leaf_list, &leaf_buffer[0], sizeof(bsp_collision_leaf) * leaf_buffer.size());
-	leaf_buffer.clear();
+	tree->n_leaves = buffers->leaf_list.size();
+	tree->leaf_list = (bsp_collision_leaf*)vm_malloc(sizeof(bsp_collision_leaf) * buffers->leaf_list.size());
+	if ( !buffers->leaf_list.empty() )
+		memcpy(tree->leaf_list, &buffers->leaf_list[0], sizeof(bsp_collision_leaf) * buffers->leaf_list.size());
 
 	// finally copy the vert list.
-	tree->vert_list = (model_tmap_vert*)vm_malloc(sizeof(model_tmap_vert) * vert_buffer.size());
-	memcpy(tree->vert_list, &vert_buffer[0], sizeof(model_tmap_vert) * vert_buffer.size());
-	vert_buffer.clear();
+	tree->vert_list = (model_tmap_vert*)vm_malloc(sizeof(model_tmap_vert) * buffers->vert_list.size());
+	if ( !buffers->vert_list.empty() )
+		memcpy(tree->vert_list, &buffers->vert_list[0], sizeof(model_tmap_vert) * buffers->vert_list.size());
+
+	// give the memory back now rather than when the buffers go away
+	std::vector<vec3d>().swap(buffers->point_list);
+	std::vector<bsp_collision_node>().swap(buffers->node_list);
+	std::vector<bsp_collision_leaf>().swap(buffers->leaf_list);
+	std::vector<model_tmap_vert>().swap(buffers->vert_list);
+}
+
+void model_collide_parse_bsp(bsp_collision_tree *tree, void *model_ptr, int version)
+{
+	bsp_collision_buffers buffers;
+
+	model_collide_parse_bsp_buffers(&buffers, model_ptr, version);
+	model_collide_fill_bsp_tree(tree, &buffers);
 }
 
 inline bool mc_shield_check_common(model_collision * MC_struct_ptr, shield_tri	*tri)
@@ -1180,6 +1190,9 @@ int model_collide(mc_info * model_collision_info)
 	model_collision * MC_struct_ptr = &MC_struct;
 	MONITOR_INC(NumFVI,1);
 
+	// in case a collision check comes in while a level is still paging in; does nothing otherwise
+	model_finish_deferred_loads();
+
 	MC_struct_ptr->MC_info = model_collision_info;
 	MC_struct_ptr->MC_info->num_hits = 0;				// How many collisions were found
 	MC_struct_ptr->MC_info->shield_hit_tri = -1;	// Assume we won't hit any shield polygons
@@ -1297,42 +1310,20 @@ int model_collide(mc_info * model_collision_info)
 
 }
 
-inline void model_collide_preprocess_subobj(vec3d *pos, matrix *orient, polymodel *pm,  polymodel_instance *pmi, int subobj_num)
+inline void model_collide_preprocess_subobj(matrix *orient, polymodel *pm, polymodel_instance *pmi, int subobj_num)
 {
-	submodel_instance *smi = &pmi->submodel[subobj_num];
+	submodel_instance *smi = model_instance_get_transform(pm, pmi, subobj_num);
 
-	smi->mc_base = *pos;
-	smi->mc_orient = *orient;
+	// the submodel hierarchy is cached in the model's RF, so just put it into the object's orientation
+	vm_vec_unrotate(&smi->mc_base, &smi->model_pos, orient);
+	vm_matrix_x_matrix(&smi->mc_orient, orient, &smi->model_orient);
 
 	int i = pm->submodel[subobj_num].first_child;
 
 	while ( i >= 0 ) {
-		angles angs = pmi->submodel[i].angs;
-		bsp_info * csm = &pm->submodel[i];
-
-		matrix tm = IDENTITY_MATRIX;
-
-		vm_vec_unrotate(pos, &csm->offset, &smi->mc_orient );
-		vm_vec_add2(pos, &smi->mc_base);
-
-		if( vm_matrix_same(&tm, &csm->orientation)) {
-			// if submodel orientation matrix is identity matrix then don't bother with matrix ops
-			vm_angles_2_matrix(&tm, &angs);
-		} else {
-			matrix rotation_matrix = csm->orientation;
-			vm_rotate_matrix_by_angles(&rotation_matrix, &angs);
-
-			matrix inv_orientation;
-			vm_copy_transpose_matrix(&inv_orientation, &csm->orientation);
-
-			vm_matrix_x_matrix(&tm, &rotation_matrix, &inv_orientation);
-		}
-
-		vm_matrix_x_matrix(orient, &smi->mc_orient, &tm);
+		model_collide_preprocess_subobj(orient, pm, pmi, i);
 
-		model_collide_preprocess_subobj(pos, orient, pm, pmi, i);
-
-		i = csm->next_sibling;
+		i = pm->submodel[i].next_sibling;
 	}
 }
 
@@ -1344,10 +1335,5 @@ void model_collide_preprocess(matrix *orient, int model_instance_num)
 	pmi = model_get_instance(model_instance_num);
 	pm = model_get(pmi->model_num);
 
-	matrix current_orient = *orient;
-	vec3d current_pos;
-
-	vm_vec_zero(&current_pos);
-
-	model_collide_preprocess_subobj(&current_pos, &current_orient, pm, pmi, pm->detail[0]);
+	model_collide_preprocess_subobj(orient, pm, pmi, pm->detail[0]);
 }
@@ -33,6 +33,7 @@
 #include "graphics/gropengllight.h"
 #include "ship/shipfx.h"
 #include "gamesequence/gamesequence.h"
+#include "render/3dcommands.h"
 
 #include <limits.h>
 
@@ -84,6 +85,16 @@ static vec3d Interp_render_box_max = ZERO_VECTOR;
 static float Interp_render_sphere_radius = 0.0f;
 static vec3d Interp_render_sphere_offset = ZERO_VECTOR;
 
+// distance based culling of small submodels, see model_render_children_buffers()
+static float Interp_pixel_scale = 0.0f;			// on-screen radius in pixels of a unit sphere at unit distance
+static float Interp_min_submodel_pixels = 0.0f;	// submodels with a smaller on-screen radius than this aren't drawn
+
+// smallest on-screen radius, in pixels, of a leaf submodel for each "Model Detail" setting
+static float Interp_submodel_pixels[MAX_DETAIL_LEVEL + 1] = { 3.0f, 2.0f, 1.5f, 1.0f, 0.5f };
+
+// models whose whole on-screen radius is smaller than this always use their lowest detail level
+#define MODEL_LOWEST_DETAIL_PIXELS		8.0f
+
 // -------------------------------------------------------------------
 // lighting save stuff 
 //
@@ -185,7 +196,8 @@ void model_render_children_buffers(polymodel * pm, int mn, int detail_level);
 int model_interp_get_texture(texture_info *tinfo, fix base_frametime);
 
 //Valathil - Transparent object buffer
-SCP_vector<transparent_submodel> transparent_submodels;
+// transparent textures are recorded here while the model is drawn and submitted once it's done
+static render_command_list Transparent_commands;
 
 void model_deallocate_interp_data()
 {
@@ -369,6 +381,9 @@ void interp_clear_instance()
 	Interp_render_box_max = vmd_zero_vector;
 	Interp_render_sphere_radius = 0.0f;
 	Interp_render_sphere_offset = vmd_zero_vector;
+
+	Interp_pixel_scale = 0.0f;
+	Interp_min_submodel_pixels = 0.0f;
 }
 
 /**
@@ -2715,6 +2730,12 @@ void model_really_render(int model_num, matrix *orient, vec3d * pos, uint flags,
 
 	vec3d closest_pos;
 	float depth = model_find_closest_point( &closest_pos, model_num, -1, orient, pos, &Eye_position );
+
+	Interp_pixel_scale = Canv_h2 * Matrix_scale.xyz.y;
+
+	// how big the whole model is on screen, if we're outside of it
+	float screen_rad = (depth > 0.0f) ? (pm->rad * Interp_pixel_scale / depth) : FLT_MAX;
+
 	if ( pm->n_detail_levels > 1 )	{
 
 		if ( Interp_flags & MR_LOCK_DETAIL )	{
@@ -2758,6 +2779,11 @@ void model_really_render(int model_num, matrix *orient, vec3d * pos, uint flags,
 			if ( (i > 1) && (pm->detail_depth[i-1] < 1.0f))	{
 				i = 1;
 			}
+
+			// only a few pixels across, so skip straight to the lowest detail level
+			if ( !(Interp_flags & MR_FULL_DETAIL) && (screen_rad < MODEL_LOWEST_DETAIL_PIXELS) ) {
+				i = pm->n_detail_levels;
+			}
 		}
 
 		// maybe force lower detail
@@ -2815,6 +2841,8 @@ void model_really_render(int model_num, matrix *orient, vec3d * pos, uint flags,
 			break;
 	}
 
+	Interp_min_submodel_pixels = Interp_submodel_pixels[Detail.detail_distance];
+
 	vec3d auto_back = ZERO_VECTOR;
 	if (Interp_flags & MR_AUTOCENTER) {
 		// standard autocenter using data in model
@@ -2934,10 +2962,6 @@ void model_really_render(int model_num, matrix *orient, vec3d * pos, uint flags,
 
 	// When in htl mode render with htl method unless its a jump node
 	if (is_outlines_only_htl || (!Cmdline_nohtl && !is_outlines_only)) {
-		transparent_submodel ts;
-		ts.is_submodel = false;
-		ts.pop_matrix = false;
-		transparent_submodels.push_back(ts);
 		model_render_buffers(pm, pm->detail[Interp_detail_level]);
 	} else {
 		model_interp_subcall(pm, pm->detail[Interp_detail_level], Interp_detail_level);
@@ -2951,10 +2975,6 @@ void model_really_render(int model_num, matrix *orient, vec3d * pos, uint flags,
 			if (pm->submodel[i].is_thruster) {
 				// When in htl mode render with htl method unless its a jump node
 				if (is_outlines_only_htl || (!Cmdline_nohtl && !is_outlines_only)) {
-					transparent_submodel ts;
-					ts.is_submodel = false;
-					ts.pop_matrix = false;
-					transparent_submodels.push_back(ts);
 					model_render_children_buffers( pm, i, Interp_detail_level );
 				} else {
 					model_interp_subcall( pm, i, Interp_detail_level );
@@ -2965,44 +2985,7 @@ void model_really_render(int model_num, matrix *orient, vec3d * pos, uint flags,
 	}
 
 	// Valathil - now draw the saved transparent objects
-	SCP_vector<transparent_submodel>::iterator ts;
-	SCP_vector<transparent_object>::iterator obj;
-
-	for(ts = transparent_submodels.begin(); ts != transparent_submodels.end(); ++ts)
-	{
-		if(ts->is_submodel)
-			g3_start_instance_matrix(&ts->model->offset, &ts->orient, true);
-
-		for(obj = ts->transparent_objects.begin(); obj != ts->transparent_objects.end(); ++obj)
-		{
-			GLOWMAP = obj->glow_map;
-			SPECMAP = obj->spec_map;
-			NORMMAP = obj->norm_map;
-			HEIGHTMAP = obj->height_map;
-			MISCMAP = obj->misc_map;
-
-			gr_push_scale_matrix(&obj->scale);
-			gr_set_bitmap(obj->texture, obj->blend_filter, GR_BITBLT_MODE_NORMAL, obj->alpha);
-
-			int zbuff = gr_zbuffer_set(GR_ZBUFF_READ);
-		
-			gr_render_buffer(0, obj->buffer, obj->i, obj->tmap_flags);
-		
-			gr_zbuffer_set(zbuff);
-			gr_pop_scale_matrix();
-
-			GLOWMAP = -1;
-			SPECMAP = -1;
-			NORMMAP = -1;
-			HEIGHTMAP = -1;
-			MISCMAP = -1;
-		}
-		ts->transparent_objects.clear();
-		
-		if(ts->pop_matrix)
-			g3_done_instance(true);
-	}
-	transparent_submodels.clear();
+	Transparent_commands.submit();
 
 	if ( !Interp_no_flush ) {
 		gr_flush_data_states();
@@ -3222,42 +3205,9 @@ void submodel_render(int model_num, int submodel_num, matrix *orient, vec3d * po
 
 		gr_set_buffer(pm->vertex_buffer_id);
 
-		transparent_submodel ts;
-		ts.is_submodel = false;
-		ts.pop_matrix = false;
-		transparent_submodels.push_back(ts);
-
 		model_render_buffers(pm, submodel_num);
 
-		SCP_vector<transparent_submodel>::iterator ts_i = transparent_submodels.begin();
-		SCP_vector<transparent_object>::iterator obj;
-			
-		for(obj = ts_i->transparent_objects.begin(); obj != ts_i->transparent_objects.end(); ++obj)
-		{
-			GLOWMAP = obj->glow_map;
-			SPECMAP = obj->spec_map;
-			NORMMAP = obj->norm_map;
-			HEIGHTMAP = obj->height_map;
-			MISCMAP = obj->misc_map;
-
-			gr_push_scale_matrix(&obj->scale);
-			gr_set_bitmap(obj->texture, obj->blend_filter, GR_BITBLT_MODE_NORMAL, obj->alpha);
-
-			int zbuff = gr_zbuffer_set(GR_ZBUFF_READ);
-		
-			gr_render_buffer(0, obj->buffer, obj->i, obj->tmap_flags);
-		
-			gr_zbuffer_set(zbuff);
-			gr_pop_scale_matrix();
-
-			GLOWMAP = -1;
-			SPECMAP = -1;
-			NORMMAP = -1;
-			HEIGHTMAP = -1;
-			MISCMAP = -1;
-		}
-		ts_i->transparent_objects.clear();
-		transparent_submodels.clear();
+		Transparent_commands.submit();
 
 		gr_set_buffer(-1);
 	} else {
@@ -4371,6 +4321,15 @@ void model_render_children_buffers(polymodel *pm, int mn, int detail_level)
 			return;
 	}
 
+	// skip leaf submodels which would only cover a pixel or so at this distance; anything with children
+	// is still drawn since the children aren't necessarily inside it
+	if ( !(Interp_flags & (MR_FULL_DETAIL | MR_LOCK_DETAIL)) && (model->first_child < 0) && (Interp_min_submodel_pixels > 0.0f) ) {
+		float dist = vm_vec_dist(&View_position, &model->offset) - model->rad;
+
+		if ( (dist > 0.0f) && (model->rad * Interp_pixel_scale < Interp_min_submodel_pixels * dist) )
+			return;
+	}
+
 	// Get submodel rotation data and use submodel orientation matrix
 	// to put together a matrix describing the final orientation of
 	// the submodel relative to its parent
@@ -4402,26 +4361,8 @@ void model_render_children_buffers(polymodel *pm, int mn, int detail_level)
 	vm_matrix_x_matrix(&submodel_matrix, &rotation_matrix, &inv_orientation);
 
 	g3_start_instance_matrix(&model->offset, &submodel_matrix, true);
-	
-	transparent_submodel ts;
-	ts.is_submodel = true;
-	ts.pop_matrix = true;
+	Transparent_commands.start_instance(&model->offset, &submodel_matrix);
 
-	bool childs = false;
-	i = model->first_child;
-	while (i >= 0) {
-		if ( !pm->submodel[i].is_thruster ) {
-			childs = true;
-			ts.pop_matrix = false;
-			break;
-		}
-
-		i = pm->submodel[i].next_sibling;
-	}
-	ts.model = model;
-	
-	memcpy(&ts.orient,&submodel_matrix,sizeof(matrix));
-	transparent_submodels.push_back(ts);
 	model_render_buffers(pm, mn, true);
 
 	if (Interp_flags & MR_SHOW_PIVOTS)
@@ -4440,14 +4381,7 @@ void model_render_children_buffers(polymodel *pm, int mn, int detail_level)
 		i = pm->submodel[i].next_sibling;
 	}
 
-	if(childs)
-	{
-		ts.is_submodel = false;
-		ts.pop_matrix = true;
-		ts.model = 0;
-		ts.transparent_objects.clear();
-		transparent_submodels.push_back(ts);
-	}
+	Transparent_commands.done_instance();
 
 	Interp_flags = fl;
 
@@ -4640,20 +4574,7 @@ void model_render_buffers(polymodel *pm, int mn, bool is_child)
 			blend_filter = GR_ALPHABLEND_FILTER;
 
 			//Valathil - Save the object for later rendering
-			transparent_object tobj;
-			tobj.alpha=alpha;
-			tobj.blend_filter = blend_filter;
-			tobj.buffer = &model->buffer;
-			tobj.glow_map = GLOWMAP;
-			tobj.height_map = HEIGHTMAP;
-			tobj.misc_map = MISCMAP;
-			tobj.i = i;
-			tobj.norm_map = NORMMAP;
-			tobj.spec_map = SPECMAP;
-			tobj.texture = texture;
-			tobj.tmap_flags = Interp_tmap_flags;
-			memcpy(&tobj.scale,&scale,sizeof(vec3d));
-			transparent_submodels.back().transparent_objects.push_back(tobj);
+			Transparent_commands.draw_buffer(&model->buffer, i, Interp_tmap_flags, texture, blend_filter, alpha, &scale, GR_ZBUFF_READ);
 		}
 		else
 		{
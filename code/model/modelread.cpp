@@ -39,6 +39,9 @@
 
 #include "gamesnd/gamesnd.h"
 
+#include "SDL_thread.h"
+#include "SDL_atomic.h"
+
 flag_def_list model_render_flags[] =
 {
 	{"no lighting",		MR_NO_LIGHTING,     0},
@@ -62,6 +65,7 @@ SCP_vector<bsp_collision_tree> Bsp_collision_tree_list;
 
 static int model_initted = 0;
 extern int Cmdline_nohtl;
+extern int Cmdline_num_threads;
 
 #ifndef NDEBUG
 CFILE *ss_fp = NULL;			// file pointer used to dump subsystem information
@@ -74,6 +78,20 @@ int Model_ram = 0;			// How much RAM the models use total
 
 static uint Global_checksum = 0;
 
+// Collision trees queued while paging in a level; see model_finish_deferred_loads()
+typedef struct deferred_collision_tree {
+	int model_id;
+	int submodel;
+	int tree_index;
+	uint checksum;
+	bsp_collision_buffers buffers;	// filled in by the worker threads, copied into the tree afterwards
+} deferred_collision_tree;
+
+static bool Model_defer_collision_trees = false;
+static SCP_vector<deferred_collision_tree> Model_deferred_trees;
+static SDL_atomic_t Model_deferred_next;
+static int Model_collision_tree_site = -1;	// registered before the model threads start
+
 // Anything less than this is considered incompatible.
 #define PM_COMPATIBLE_VERSION 1900
 
@@ -225,6 +243,12 @@ void model_unload(int modelnum, int force)
 
 	model_octant_free( pm );
 
+	// drop any collision trees still waiting to be built for this model
+	for (i = (int)Model_deferred_trees.size() - 1; i >= 0; i--) {
+		if (Model_deferred_trees[i].model_id == pm->id)
+			Model_deferred_trees.erase(Model_deferred_trees.begin() + i);
+	}
+
 	if (pm->submodel) {
 		for (i = 0; i < pm->n_models; i++) {
 			if ( !Cmdline_nohtl ) {
@@ -320,6 +344,9 @@ void model_page_in_start()
 {
 	int i;
 
+	// with worker threads available, build collision trees in one go at the end of paging
+	Model_defer_collision_trees = (Cmdline_num_threads > 1);
+
 	if ( !model_initted ) {
 		model_init();
 		return;
@@ -341,6 +368,9 @@ void model_page_in_stop()
 
 	mprintf(( "Stopping model page in...\n" ));
 
+	model_finish_deferred_loads();
+	Model_defer_collision_trees = false;
+
 	for (i=0; i<MAX_POLYGON_MODELS; i++) {
 		if (Polygon_models[i] == NULL)
 			continue;
@@ -945,6 +975,264 @@ void model_calc_bound_box( vec3d *box, vec3d *big_mn, vec3d *big_mx)
 void parse_triggers(int &n_trig, queued_animation **triggers, char *props);
 
 
+// Baked collision trees (BCX).  model_collide_parse_bsp() walks the BSP data of every submodel each time
+// a model is loaded, but what it builds is just flat arrays linked by index.  So those arrays are kept in
+// the cache directory next to the IBX files, checked against the POF checksum, and read back in one go.
+#define BCX_ID				0x42435820		// "BCX " - ("  XCB" in file)
+#define BCX_VERSION			1
+#define BCX_HEADER_INTS		7
+
+static void model_collision_cache_filename(polymodel *pm, char *out, size_t out_size)
+{
+	strcpy_s(out, out_size, pm->filename);
+	char *pb = strchr(out, '.');
+	if (pb) *pb = 0;
+	strcat_s(out, out_size, NOX(".bcx"));
+}
+
+// number of texture verts a tree uses, which the tree itself doesn't keep
+static int model_collision_tree_tmap_verts(bsp_collision_tree *tree)
+{
+	int n = 0;
+
+	for (int i = 0; i < tree->n_leaves; i++)
+		n = MAX(n, tree->leaf_list[i].vert_start + tree->leaf_list[i].num_verts);
+
+	return n;
+}
+
+template <class T>
+static T *model_collision_cache_copy(ubyte *&p, int count)
+{
+	if (count <= 0)
+		return NULL;
+
+	T *out = (T*)vm_malloc(sizeof(T) * count);
+	memcpy(out, p, sizeof(T) * count);
+	p += sizeof(T) * count;
+
+	return out;
+}
+
+// sets up the collision trees of all submodels from the cache, or returns false if it's missing or stale
+static bool model_read_collision_cache(polymodel *pm)
+{
+	char name[MAX_FILENAME_LEN];
+	model_collision_cache_filename(pm, name, sizeof(name));
+
+	CFILE *cfp = cfopen(name, "rb", CFILE_NORMAL, CF_TYPE_CACHE);
+	if (cfp == NULL)
+		return false;
+
+	int size = cfilelength(cfp);
+	if (size < (int)(BCX_HEADER_INTS * sizeof(int))) {
+		cfclose(cfp);
+		return false;
+	}
+
+	ubyte *buffer = (ubyte*)vm_malloc(size);
+	bool valid = (cfread(buffer, size, 1, cfp) == 1);
+	cfclose(cfp);
+
+	int *header = (int*)buffer;
+	valid = valid
+		&& (header[0] == BCX_ID)
+		&& (header[1] == BCX_VERSION)
+		&& ((uint)header[2] == Global_checksum)
+		&& (header[3] == pm->n_models)
+		&& (header[4] == (int)sizeof(bsp_collision_node))
+		&& (header[5] == (int)sizeof(bsp_collision_leaf))
+		&& (header[6] == (int)sizeof(model_tmap_vert));
+
+	// check every submodel's counts against the file size before using any of it
+	ubyte *end = buffer + size;
+	ubyte *p = buffer + BCX_HEADER_INTS * sizeof(int);
+	int i;
+
+	for (i = 0; valid && i < pm->n_models; i++) {
+		if (p + 4 * sizeof(int) > end) {
+			valid = false;
+			break;
+		}
+
+		int *counts = (int*)p;
+		if ( (counts[0] < 0) || (counts[1] < 0) || (counts[2] < 0) || (counts[3] < 0) ) {
+			valid = false;
+			break;
+		}
+
+		p += 4 * sizeof(int);
+		p += counts[0] * sizeof(vec3d) + counts[1] * sizeof(bsp_collision_node) + counts[2] * sizeof(bsp_collision_leaf) + counts[3] * sizeof(model_tmap_vert);
+		if (p > end)
+			valid = false;
+	}
+
+	if (!valid) {
+		mprintf(("BCX: Warning!  Found invalid BCX file: '%s'\n", name));
+		vm_free(buffer);
+		return false;
+	}
+
+	p = buffer + BCX_HEADER_INTS * sizeof(int);
+
+	for (i = 0; i < pm->n_models; i++) {
+		int *counts = (int*)p;
+		p += 4 * sizeof(int);
+
+		pm->submodel[i].collision_tree_index = model_create_bsp_collision_tree();
+		bsp_collision_tree *tree = model_get_bsp_collision_tree(pm->submodel[i].collision_tree_index);
+
+		tree->n_verts = counts[0];
+		tree->n_nodes = counts[1];
+		tree->n_leaves = counts[2];
+
+		tree->point_list = model_collision_cache_copy<vec3d>(p, counts[0]);
+		tree->node_list = model_collision_cache_copy<bsp_collision_node>(p, counts[1]);
+		tree->leaf_list = model_collision_cache_copy<bsp_collision_leaf>(p, counts[2]);
+		tree->vert_list = model_collision_cache_copy<model_tmap_vert>(p, counts[3]);
+	}
+
+	vm_free(buffer);
+
+	mprintf(("BCX: Found a good BCX to read for '%s'.\n", pm->filename));
+
+	return true;
+}
+
+static void model_write_collision_cache(polymodel *pm, uint checksum)
+{
+	char name[MAX_FILENAME_LEN];
+	model_collision_cache_filename(pm, name, sizeof(name));
+
+	CFILE *cfp = cfopen(name, "wb", CFILE_NORMAL, CF_TYPE_CACHE);
+	if (cfp == NULL)
+		return;
+
+	cfwrite_int(BCX_ID, cfp);
+	cfwrite_int(BCX_VERSION, cfp);
+	cfwrite_uint(checksum, cfp);
+	cfwrite_int(pm->n_models, cfp);
+	cfwrite_int((int)sizeof(bsp_collision_node), cfp);
+	cfwrite_int((int)sizeof(bsp_collision_leaf), cfp);
+	cfwrite_int((int)sizeof(model_tmap_vert), cfp);
+
+	for (int i = 0; i < pm->n_models; i++) {
+		bsp_collision_tree *tree = model_get_bsp_collision_tree(pm->submodel[i].collision_tree_index);
+		int n_tmap_verts = model_collision_tree_tmap_verts(tree);
+
+		cfwrite_int(tree->n_verts, cfp);
+		cfwrite_int(tree->n_nodes, cfp);
+		cfwrite_int(tree->n_leaves, cfp);
+		cfwrite_int(n_tmap_verts, cfp);
+
+		if (tree->n_verts > 0)
+			cfwrite(tree->point_list, sizeof(vec3d), tree->n_verts, cfp);
+		if (tree->n_nodes > 0)
+			cfwrite(tree->node_list, sizeof(bsp_collision_node), tree->n_nodes, cfp);
+		if (tree->n_leaves > 0)
+			cfwrite(tree->leaf_list, sizeof(bsp_collision_leaf), tree->n_leaves, cfp);
+		if (n_tmap_verts > 0)
+			cfwrite(tree->vert_list, sizeof(model_tmap_vert), n_tmap_verts, cfp);
+	}
+
+	cfclose(cfp);
+
+	mprintf(("BCX: Wrote a new BCX for '%s'.\n", pm->filename));
+}
+
+static int model_collision_tree_thread(void *name)
+{
+	int count = (int)Model_deferred_trees.size();
+
+	if (name != NULL)
+		profile_thread_name((const char*)name);
+
+	for (;;) {
+		int i = SDL_AtomicAdd(&Model_deferred_next, 1);
+		if (i >= count)
+			break;
+
+		deferred_collision_tree *job = &Model_deferred_trees[i];
+		polymodel *pm = Polygon_models[job->model_id % MAX_POLYGON_MODELS];
+
+		profile_begin(Model_collision_tree_site);
+		model_collide_parse_bsp_buffers(&job->buffers, pm->submodel[job->submodel].bsp_data, pm->version);
+		profile_end(Model_collision_tree_site);
+	}
+
+	if (name != NULL)
+		profile_thread_exit();
+
+	return 0;
+}
+
+// Builds the collision trees queued up by read_model_file() while paging in a level.  The BSP data of
+// each submodel is parsed into the job's own buffers, which don't use vm_malloc, so that part is spread
+// over Cmdline_num_threads threads.  The trees' vm_malloc'd lists are filled in on the main thread once
+// the threads are done.  Everything else about a model (textures, vertex buffers) is still loaded on the
+// main thread.
+void model_finish_deferred_loads()
+{
+	size_t i;
+
+	if (Model_deferred_trees.empty())
+		return;
+
+	int num_threads = MIN(Cmdline_num_threads, (int)Model_deferred_trees.size()) - 1;
+	SCP_vector<SDL_Thread*> threads;
+
+	mprintf(( "Building %d collision trees on %d threads...\n", (int)Model_deferred_trees.size(), num_threads + 1 ));
+
+	SDL_AtomicSet(&Model_deferred_next, 0);
+
+	if (Model_collision_tree_site < 0)
+		Model_collision_tree_site = profile_site("Collision Tree");
+
+	// the names have to stay around for as long as the threads do
+	SCP_vector<SCP_string> names;
+	names.resize(MAX(num_threads, 0));
+
+	for (int t = 0; t < num_threads; t++) {
+		char name[32];
+		sprintf(name, "Model Thread %d", t);
+		names[t] = name;
+
+		SDL_Thread *thread = SDL_CreateThread(model_collision_tree_thread, name, (void*)names[t].c_str());
+		if (thread == NULL) {
+			mprintf(( "Unable to create model thread: %s\n", SDL_GetError() ));
+			break;
+		}
+
+		threads.push_back(thread);
+	}
+
+	// this thread does its share too, and all of it if no other threads could be made
+	model_collision_tree_thread(NULL);
+
+	for (i = 0; i < threads.size(); i++)
+		SDL_WaitThread(threads[i], NULL);
+
+	for (i = 0; i < Model_deferred_trees.size(); i++) {
+		bsp_collision_tree *tree = model_get_bsp_collision_tree(Model_deferred_trees[i].tree_index);
+		model_collide_fill_bsp_tree(tree, &Model_deferred_trees[i].buffers);
+	}
+
+	// the cache files have to be written from here, once all of a model's trees are done
+	if ( !Cmdline_noibx ) {
+		int last_id = -1;
+
+		for (i = 0; i < Model_deferred_trees.size(); i++) {
+			if (Model_deferred_trees[i].model_id == last_id)
+				continue;
+
+			last_id = Model_deferred_trees[i].model_id;
+			model_write_collision_cache(Polygon_models[last_id % MAX_POLYGON_MODELS], Model_deferred_trees[i].checksum);
+		}
+	}
+
+	Model_deferred_trees.clear();
+}
+
 //reads a binary file containing a 3d model
 int read_model_file(polymodel * pm, char *filename, int n_subsystems, model_subsystem *subsystems, int ferror)
 {
@@ -2662,11 +2950,32 @@ int model_load(char *filename, int n_subsystems, model_subsystem *subsystems, in
 
 	model_octant_create( pm );
 
-	for (i = 0; i < pm->n_models; ++i) {
-		pm->submodel[i].collision_tree_index = model_create_bsp_collision_tree();
-		bsp_collision_tree *tree = model_get_bsp_collision_tree(pm->submodel[i].collision_tree_index);
+	if ( Cmdline_noibx || !model_read_collision_cache(pm) ) {
+		for (i = 0; i < pm->n_models; ++i) {
+			pm->submodel[i].collision_tree_index = model_create_bsp_collision_tree();
+			bsp_collision_tree *tree = model_get_bsp_collision_tree(pm->submodel[i].collision_tree_index);
+
+			if (Model_defer_collision_trees) {
+				deferred_collision_tree job;
+
+				// empty until it's built, in case the model is unloaded first
+				memset(tree, 0, sizeof(bsp_collision_tree));
+				tree->used = true;
+
+				job.model_id = pm->id;
+				job.submodel = i;
+				job.tree_index = pm->submodel[i].collision_tree_index;
+				job.checksum = Global_checksum;
+
+				Model_deferred_trees.push_back(job);
+				continue;
+			}
 
-		model_collide_parse_bsp(tree, pm->submodel[i].bsp_data, pm->version);
+			model_collide_parse_bsp(tree, pm->submodel[i].bsp_data, pm->version);
+		}
+
+		if ( !Cmdline_noibx && !Model_defer_collision_trees )
+			model_write_collision_cache(pm, Global_checksum);
 	}
 
 	// Find the core_radius... the minimum of 
@@ -2731,9 +3040,14 @@ int model_create_instance(int model_num, int submodel_num)
 
 	for ( i = 0; i < pm->n_models; i++ ) {
 		model_clear_submodel_instance( &pmi->submodel[i] );
+
+		// nothing is cached yet; clearing the angles alone leaves the cache be, it's checked against the angles
+		pmi->submodel[i].xform_stamp = 0;
+		pmi->submodel[i].parent_xform_stamp = 0;
 	}
 
 	pmi->model_num = model_num;
+	pmi->xform_counter = 0;
 
 	if ( submodel_num < 0 ) {
 		// if using default arguments, use detail0 as the root submodel
@@ -3241,33 +3555,18 @@ void model_find_obj_dir(vec3d *w_vec, vec3d *m_vec, object *ship_obj, int sub_mo
 void model_instance_find_obj_dir(vec3d *w_vec, vec3d *m_vec, object *ship_obj, int sub_model_num)
 {
 	vec3d tvec, vec;
-	matrix m;
-	int mn;
 
 	Assert(ship_obj->type == OBJ_SHIP);
 
 	polymodel_instance *pmi = model_get_instance(Ships[ship_obj->instance].model_instance_num);
 	polymodel *pm = model_get(Ship_info[Ships[ship_obj->instance].ship_info_index].model_num);
 	vec = *m_vec;
-	mn = sub_model_num;
 
-	// instance up the tree for this point
-	while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
-		// By using this kind of computation, the rotational angles can always
-		// be computed relative to the submodel itself, instead of relative
-		// to the parent - KeldorKatarn
-		matrix rotation_matrix = pm->submodel[mn].orientation;
-		vm_rotate_matrix_by_angles(&rotation_matrix, &pmi->submodel[mn].angs);
-
-		matrix inv_orientation;
-		vm_copy_transpose_matrix(&inv_orientation, &pm->submodel[mn].orientation);
+	if (sub_model_num >= 0) {
+		submodel_instance *smi = model_instance_get_transform(pm, pmi, sub_model_num);
 
-		vm_matrix_x_matrix(&m, &rotation_matrix, &inv_orientation);
-
-		vm_vec_unrotate(&tvec, &vec, &m);
+		vm_vec_unrotate(&tvec, &vec, &smi->model_orient);
 		vec = tvec;
-
-		mn = pm->submodel[mn].parent;
 	}
 
 	// now instance for the entire object
@@ -3991,33 +4290,17 @@ void model_find_world_point(vec3d * outpnt, vec3d *mpnt,int model_num,int sub_mo
 void model_instance_find_world_point(vec3d * outpnt, vec3d *mpnt, int model_num, int model_instance_num, int sub_model_num, matrix * objorient, vec3d * objpos )
 {
 	vec3d pnt;
-	vec3d tpnt;
-	matrix m;
-	int mn;
 	polymodel *pm = model_get(model_num);
 	polymodel_instance *pmi = model_get_instance(model_instance_num);
 
 	pnt = *mpnt;
-	mn = sub_model_num;
 
 	//instance up the tree for this point
-	while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
-		// By using this kind of computation, the rotational angles can always
-		// be computed relative to the submodel itself, instead of relative
-		// to the parent - KeldorKatarn
-		matrix rotation_matrix = pm->submodel[mn].orientation;
-		vm_rotate_matrix_by_angles(&rotation_matrix, &pmi->submodel[mn].angs);
-
-		matrix inv_orientation;
-		vm_copy_transpose_matrix(&inv_orientation, &pm->submodel[mn].orientation);
-
-		vm_matrix_x_matrix(&m, &rotation_matrix, &inv_orientation);
-
-		vm_vec_unrotate(&tpnt, &pnt, &m);
+	if (sub_model_num >= 0) {
+		submodel_instance *smi = model_instance_get_transform(pm, pmi, sub_model_num);
 
-		vm_vec_add(&pnt, &tpnt, &pm->submodel[mn].offset);
-
-		mn = pm->submodel[mn].parent;
+		vm_vec_unrotate(&pnt, mpnt, &smi->model_orient);
+		vm_vec_add2(&pnt, &smi->model_pos);
 	}
 
 	//now instance for the entire object
@@ -4073,7 +4356,6 @@ void world_find_model_instance_point(vec3d *out, vec3d *world_pt, polymodel *pm,
 	Assert( (pm->submodel[submodel_num].parent == pm->detail[0]) || (pm->submodel[submodel_num].parent == -1) );
 
 	vec3d tempv1, tempv2;
-	matrix m;
 
 	// get into ship RF
 	vm_vec_sub(&tempv1, world_pt, pos);
@@ -4087,18 +4369,9 @@ void world_find_model_instance_point(vec3d *out, vec3d *world_pt, polymodel *pm,
 	// put into submodel RF
 	vm_vec_sub2(&tempv2, &pm->submodel[submodel_num].offset);
 
-	// By using this kind of computation, the rotational angles can always
-	// be computed relative to the submodel itself, instead of relative
-	// to the parent - KeldorKatarn
-	matrix rotation_matrix = pm->submodel[submodel_num].orientation;
-	vm_rotate_matrix_by_angles(&rotation_matrix, &pmi->submodel[submodel_num].angs);
+	submodel_instance *smi = model_instance_get_transform(pm, pmi, submodel_num);
 
-	matrix inv_orientation;
-	vm_copy_transpose_matrix(&inv_orientation, &pm->submodel[submodel_num].orientation);
-
-	vm_matrix_x_matrix(&m, &rotation_matrix, &inv_orientation);
-
-	vm_vec_rotate(out, &tempv2, &m);
+	vm_vec_rotate(out, &tempv2, &smi->local_orient);
 }
 
 /**
@@ -4114,28 +4387,24 @@ void find_submodel_instance_point(vec3d *outpnt, object *ship_obj, int submodel_
 	Assert(ship_obj->type == OBJ_SHIP);
 
 	vm_vec_zero(outpnt);
-	matrix submodel_instance_matrix, rotation_matrix, inv_orientation;
+
+	if (submodel_num < 0)
+		return;
 
 	polymodel_instance *pmi = model_get_instance(Ships[ship_obj->instance].model_instance_num);
 	polymodel *pm = model_get(Ship_info[Ships[ship_obj->instance].ship_info_index].model_num);
 
+	// the cached rotations of the whole parent chain are brought up to date along with the submodel's
+	model_instance_get_transform(pm, pmi, submodel_num);
+
 	int mn = submodel_num;
 	while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
 		vec3d offset = pm->submodel[mn].offset;
 
 		int parent_mn = pm->submodel[mn].parent;
 
-		if (pm->submodel[parent_mn].can_move) {
-			rotation_matrix = pm->submodel[parent_mn].orientation;
-			vm_rotate_matrix_by_angles(&rotation_matrix, &pmi->submodel[parent_mn].angs);
-
-			vm_copy_transpose_matrix(&inv_orientation, &pm->submodel[parent_mn].orientation);
-
-			vm_matrix_x_matrix(&submodel_instance_matrix, &rotation_matrix, &inv_orientation);
-
-			vec3d tvec = offset;
-			vm_vec_unrotate(&offset, &tvec, &submodel_instance_matrix);
-		}
+		vec3d tvec = offset;
+		vm_vec_unrotate(&offset, &tvec, &pmi->submodel[parent_mn].local_orient);
 
 		vm_vec_add2(outpnt, &offset);
 
@@ -4161,48 +4430,39 @@ void find_submodel_instance_point_normal(vec3d *outpnt, vec3d *outnorm, object *
 
 	*outnorm = *submodel_norm;
 	vm_vec_zero(outpnt);
-	matrix submodel_instance_matrix, rotation_matrix, inv_orientation;
+
+	if (submodel_num < 0)
+		return;
 
 	polymodel_instance *pmi = model_get_instance(Ships[ship_obj->instance].model_instance_num);
 	polymodel *pm = model_get(Ship_info[Ships[ship_obj->instance].ship_info_index].model_num);
 
+	// the cached rotations of the whole parent chain are brought up to date along with the submodel's
+	submodel_instance *smi = model_instance_get_transform(pm, pmi, submodel_num);
+
 	int mn = submodel_num;
 	while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
 		vec3d offset = pm->submodel[mn].offset;
 
 		if ( mn == submodel_num) {
-			vec3d submodel_pnt_offset = *submodel_pnt;
-
-			rotation_matrix = pm->submodel[submodel_num].orientation;
-			vm_rotate_matrix_by_angles(&rotation_matrix, &pmi->submodel[submodel_num].angs);
-
-			vm_copy_transpose_matrix(&inv_orientation, &pm->submodel[submodel_num].orientation);
-
-			vm_matrix_x_matrix(&submodel_instance_matrix, &rotation_matrix, &inv_orientation);
-
-			vec3d tvec = submodel_pnt_offset;
-			vm_vec_unrotate(&submodel_pnt_offset, &tvec, &submodel_instance_matrix);
+			vec3d submodel_pnt_offset;
+			vm_vec_unrotate(&submodel_pnt_offset, submodel_pnt, &smi->local_orient);
 
 			vec3d tnorm = *outnorm;
-			vm_vec_unrotate(outnorm, &tnorm, &submodel_instance_matrix);
+			vm_vec_unrotate(outnorm, &tnorm, &smi->local_orient);
 
 			vm_vec_add2(&offset, &submodel_pnt_offset);
 		}
 
 		int parent_model_num = pm->submodel[mn].parent;
 
-		rotation_matrix = pm->submodel[parent_model_num].orientation;
-		vm_rotate_matrix_by_angles(&rotation_matrix, &pmi->submodel[parent_model_num].angs);
-
-		vm_copy_transpose_matrix(&inv_orientation, &pm->submodel[parent_model_num].orientation);
-
-		vm_matrix_x_matrix(&submodel_instance_matrix, &rotation_matrix, &inv_orientation);
+		matrix *parent_matrix = &pmi->submodel[parent_model_num].local_orient;
 
 		vec3d tvec = offset;
-		vm_vec_unrotate(&offset, &tvec, &submodel_instance_matrix);
+		vm_vec_unrotate(&offset, &tvec, parent_matrix);
 
 		vec3d tnorm = *outnorm;
-		vm_vec_unrotate(outnorm, &tnorm, &submodel_instance_matrix);
+		vm_vec_unrotate(outnorm, &tnorm, parent_matrix);
 
 		vm_vec_add2(outpnt, &offset);
 
@@ -4231,48 +4491,39 @@ void find_submodel_instance_point_orient(vec3d *outpnt, matrix *outorient, objec
 
 	*outorient = *submodel_orient;
 	vm_vec_zero(outpnt);
-	matrix submodel_instance_matrix, rotation_matrix, inv_orientation;
+
+	if (submodel_num < 0)
+		return;
 
 	polymodel_instance *pmi = model_get_instance(Ships[ship_obj->instance].model_instance_num);
 	polymodel *pm = model_get(Ship_info[Ships[ship_obj->instance].ship_info_index].model_num);
 
+	// the cached rotations of the whole parent chain are brought up to date along with the submodel's
+	submodel_instance *smi = model_instance_get_transform(pm, pmi, submodel_num);
+
 	int mn = submodel_num;
 	while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
 		vec3d offset = pm->submodel[mn].offset;
 
 		if ( mn == submodel_num) {
-			vec3d submodel_pnt_offset = *submodel_pnt;
-
-			rotation_matrix = pm->submodel[submodel_num].orientation;
-			vm_rotate_matrix_by_angles(&rotation_matrix, &pmi->submodel[submodel_num].angs);
-
-			vm_copy_transpose_matrix(&inv_orientation, &pm->submodel[submodel_num].orientation);
-
-			vm_matrix_x_matrix(&submodel_instance_matrix, &rotation_matrix, &inv_orientation);
-
-			vec3d tvec = submodel_pnt_offset;
-			vm_vec_unrotate(&submodel_pnt_offset, &tvec, &submodel_instance_matrix);
+			vec3d submodel_pnt_offset;
+			vm_vec_unrotate(&submodel_pnt_offset, submodel_pnt, &smi->local_orient);
 
 			matrix tnorm = *outorient;
-			vm_matrix_x_matrix(outorient, &tnorm, &submodel_instance_matrix);
+			vm_matrix_x_matrix(outorient, &tnorm, &smi->local_orient);
 
 			vm_vec_add2(&offset, &submodel_pnt_offset);
 		}
 
 		int parent_model_num = pm->submodel[mn].parent;
 
-		rotation_matrix = pm->submodel[parent_model_num].orientation;
-		vm_rotate_matrix_by_angles(&rotation_matrix, &pmi->submodel[parent_model_num].angs);
-
-		vm_copy_transpose_matrix(&inv_orientation, &pm->submodel[parent_model_num].orientation);
-
-		vm_matrix_x_matrix(&submodel_instance_matrix, &rotation_matrix, &inv_orientation);
+		matrix *parent_matrix = &pmi->submodel[parent_model_num].local_orient;
 
 		vec3d tvec = offset;
-		vm_vec_unrotate(&offset, &tvec, &submodel_instance_matrix);
+		vm_vec_unrotate(&offset, &tvec, parent_matrix);
 
 		matrix tnorm = *outorient;
-		vm_matrix_x_matrix(outorient, &tnorm, &submodel_instance_matrix);
+		vm_matrix_x_matrix(outorient, &tnorm, parent_matrix);
 
 		vm_vec_add2(outpnt, &offset);
 
@@ -4425,32 +4676,16 @@ void model_find_world_dir(vec3d * out_dir, vec3d *in_dir,int model_num, int sub_
 void model_instance_find_world_dir(vec3d * out_dir, vec3d *in_dir,int model_num, int model_instance_num, int sub_model_num, matrix * objorient, vec3d * objpos )
 {
 	vec3d pnt;
-	vec3d tpnt;
-	matrix m;
-	int mn;
 	polymodel *pm = model_get(model_num);
 	polymodel_instance *pmi = model_get_instance(model_instance_num);
 
 	pnt = *in_dir;
-	mn = sub_model_num;
 
 	//instance up the tree for this point
-	while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
-		// By using this kind of computation, the rotational angles can always
-		// be computed relative to the submodel itself, instead of relative
-		// to the parent - KeldorKatarn
-		matrix rotation_matrix = pm->submodel[mn].orientation;
-		vm_rotate_matrix_by_angles(&rotation_matrix, &pmi->submodel[mn].angs);
-
-		matrix inv_orientation;
-		vm_copy_transpose_matrix(&inv_orientation, &pm->submodel[mn].orientation);
-
-		vm_matrix_x_matrix(&m, &rotation_matrix, &inv_orientation);
+	if (sub_model_num >= 0) {
+		submodel_instance *smi = model_instance_get_transform(pm, pmi, sub_model_num);
 
-		vm_vec_unrotate(&tpnt, &pnt, &m);
-		pnt = tpnt;
-
-		mn = pm->submodel[mn].parent;
+		vm_vec_unrotate(&pnt, in_dir, &smi->model_orient);
 	}
 
 	//now instance for the entire object
@@ -4682,6 +4917,72 @@ void model_update_instance(int model_instance_num, int sub_model_num, submodel_i
 	}
 }
 
+submodel_instance *model_instance_get_transform(polymodel *pm, polymodel_instance *pmi, int submodel_num)
+{
+	Assert( (submodel_num >= 0) && (submodel_num < pm->n_models) );
+
+	submodel_instance *smi = &pmi->submodel[submodel_num];
+	bsp_info *sm = &pm->submodel[submodel_num];
+	bool rebuild = (smi->xform_stamp == 0);
+
+	// the angles are compared rather than flagged, since collision code swaps angs in and out directly
+	if ( rebuild || (smi->angs.p != smi->xform_angs.p) || (smi->angs.b != smi->xform_angs.b) || (smi->angs.h != smi->xform_angs.h) ) {
+		if ( vm_matrix_same(&vmd_identity_matrix, &sm->orientation) ) {
+			// if submodel orientation matrix is identity matrix then don't bother with matrix ops
+			vm_angles_2_matrix(&smi->local_orient, &smi->angs);
+		} else {
+			// By using this kind of computation, the rotational angles can always
+			// be computed relative to the submodel itself, instead of relative
+			// to the parent - KeldorKatarn
+			matrix rotation_matrix = sm->orientation;
+			vm_rotate_matrix_by_angles(&rotation_matrix, &smi->angs);
+
+			matrix inv_orientation;
+			vm_copy_transpose_matrix(&inv_orientation, &sm->orientation);
+
+			vm_matrix_x_matrix(&smi->local_orient, &rotation_matrix, &inv_orientation);
+		}
+
+		smi->xform_angs = smi->angs;
+		rebuild = true;
+	}
+
+	if (sm->parent < 0) {
+		// the top of the hierarchy is the model's frame of reference; its own rotation isn't applied
+		if (rebuild) {
+			smi->model_orient = vmd_identity_matrix;
+			vm_vec_zero(&smi->model_pos);
+			smi->xform_stamp = ++pmi->xform_counter;
+		}
+
+		return smi;
+	}
+
+	submodel_instance *parent = model_instance_get_transform(pm, pmi, sm->parent);
+
+	if ( rebuild || (smi->parent_xform_stamp != parent->xform_stamp) ) {
+		vm_vec_unrotate(&smi->model_pos, &sm->offset, &parent->model_orient);
+		vm_vec_add2(&smi->model_pos, &parent->model_pos);
+
+		vm_matrix_x_matrix(&smi->model_orient, &parent->model_orient, &smi->local_orient);
+
+		smi->parent_xform_stamp = parent->xform_stamp;
+		smi->xform_stamp = ++pmi->xform_counter;
+	}
+
+	return smi;
+}
+
+void model_instance_update_transforms(int model_instance_num)
+{
+	polymodel_instance *pmi = model_get_instance(model_instance_num);
+	polymodel *pm = model_get(pmi->model_num);
+
+	for (int i = 0; i < pm->n_models; i++) {
+		model_instance_get_transform(pm, pmi, i);
+	}
+}
+
 void model_instance_dumb_rotation_sub(polymodel_instance * pmi, polymodel *pm, int mn)
 {
 	while ( mn >= 0 )	{
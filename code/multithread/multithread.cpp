@@ -79,6 +79,10 @@ SCP_hash_map<unsigned int, collision_data> collision_cache;
 int supercollider_thread(void *num);
 int collider_quicksort_thread(void *num);
 
+// profiling sites used on the threads, registered in create_threads() before any of them start
+static int Collision_eval_site = -1;
+static int Collider_quicksort_site = -1;
+
 //char *pref_path = NULL;
 //
 //void InitializePrefPath() {
@@ -171,6 +175,9 @@ void create_threads()
 		thread_number.push_back(i);
 	}
 
+	Collision_eval_site = profile_site("Collision Eval");
+	Collider_quicksort_site = profile_site("Collider Quicksort");
+
 	while(!collision_quicksort_queue.empty())
 	{
 		collision_quicksort_queue.pop();
@@ -280,6 +287,94 @@ void destroy_threads()
 	SDL_DestroyCond(quicksort_queue_condition);
 }
 
+/**
+ * Runs job(0) .. job(count - 1) on the quicksort threads and returns once all of them are done.  The jobs are
+ * handed out in chunks of at least min_per_chunk, and the calling thread works through the queue as well.  The
+ * jobs must not depend on each other or on the order they're run in.
+ */
+void multithread_run_jobs(multithread_job_func job, int count, int min_per_chunk)
+{
+	collider_quicksort_vars vars;
+	int i, chunk;
+	bool busy;
+
+	if (count <= 0) {
+		return;
+	}
+
+	// not worth waking anyone up for
+	if (!threads_alive || (Cmdline_num_threads < 2) || (count < 2 * min_per_chunk)) {
+		for (i = 0; i < count; i++) {
+			job(i);
+		}
+		return;
+	}
+
+	// a couple of chunks per thread, so that a slow chunk doesn't hold everyone else up
+	chunk = MAX(min_per_chunk, (count + (2 * Cmdline_num_threads) - 1) / (2 * Cmdline_num_threads));
+
+	vars.list = NULL;
+	vars.axis = 0;
+	vars.job = job;
+
+	if (SDL_LockMutex(quicksort_queue_mutex) < 0) {
+		Error(LOCATION, "quicksort_queue_mutex lock failed: %s\n", SDL_GetError());
+	}
+	for (i = 0; i < count; i += chunk) {
+		vars.left = i;
+		vars.right = MIN(i + chunk, count) - 1;
+		collision_quicksort_queue.push(vars);
+	}
+	if (SDL_CondBroadcast(quicksort_queue_condition) < 0) {
+		Error(LOCATION, "collider_quicksort_thread conditionl var signal failed: %s\n", SDL_GetError());
+	}
+
+	// the queue lock is held at the top of the loop
+	while (1) {
+		if (!collision_quicksort_queue.empty()) {
+			vars = collision_quicksort_queue.front();
+			collision_quicksort_queue.pop();
+			if (SDL_UnlockMutex(quicksort_queue_mutex) < 0) {
+				Error(LOCATION, "quicksort_queue_mutex unlock failed: %s\n", SDL_GetError());
+			}
+
+			Assert(vars.job == job);
+			for (i = vars.left; i <= vars.right; i++) {
+				job(i);
+			}
+
+			if (SDL_LockMutex(quicksort_queue_mutex) < 0) {
+				Error(LOCATION, "quicksort_queue_mutex lock failed: %s\n", SDL_GetError());
+			}
+			continue;
+		}
+
+		// a thread only goes back to idle once it finds the queue empty, so this is safe to check under the lock
+		busy = false;
+		for (i = 0; i < Cmdline_num_threads; i++) {
+			if (collision_quicksort_state[i].status == PROCESS_STATE_BUSY) {
+				busy = true;
+				break;
+			}
+		}
+
+		if (!busy) {
+			break;
+		}
+
+		if (SDL_UnlockMutex(quicksort_queue_mutex) < 0) {
+			Error(LOCATION, "quicksort_queue_mutex unlock failed: %s\n", SDL_GetError());
+		}
+		SDL_Delay(0);
+		if (SDL_LockMutex(quicksort_queue_mutex) < 0) {
+			Error(LOCATION, "quicksort_queue_mutex lock failed: %s\n", SDL_GetError());
+		}
+	}
+	if (SDL_UnlockMutex(quicksort_queue_mutex) < 0) {
+		Error(LOCATION, "quicksort_queue_mutex unlock failed: %s\n", SDL_GetError());
+	}
+}
+
 void collision_pair_clear()
 {
 	collision_list.clear();
@@ -454,6 +549,11 @@ void collision_pair_add(object *object_1, object *object_2)
 		}
 	}
 
+	// the collider threads can't use vm_malloc, so the space for the hit data is found here
+	if (data->exec_data == NULL) {
+		data->exec_data = (collision_exec_data*)vm_malloc(sizeof(collision_exec_data));
+	}
+
 	collision_list.push_back(key);
 }
 
@@ -494,7 +594,6 @@ void evaluate_collisions()
 					if (SDL_CondSignal(conditions[thread_counter].condition) < 0) {
 						Error(LOCATION, "supercollider conditional var signal failed: %s\n", SDL_GetError());
 					}
-					SDL_return = SDL_UnlockMutex(conditions[thread_counter].mutex);
 					if (SDL_UnlockMutex(conditions[thread_counter].mutex) < 0) {
 						Error(LOCATION, "supercollider mutex unlock failed: %s\n", SDL_GetError());
 					}
@@ -575,6 +674,10 @@ int supercollider_thread(void *num)
 {
 	int thread_num = *(int *) num;
 	collision_exec_data temp_data;
+	char name[32];
+
+	sprintf(name, "Collider Thread %d", thread_num);
+	profile_thread_name(name);
 
 	if (SDL_LockMutex(conditions[thread_num].mutex) < 0) {
 		Error(LOCATION, "supercollider mutex lock failed: %s\n", SDL_GetError());
@@ -585,22 +688,23 @@ int supercollider_thread(void *num)
 		}
 		if (threads_alive == false) {
 			//check for exit condition
+			profile_thread_exit();
 			return 0;
 		}
+		if (thread_collision_vars[thread_num].collision == NULL) {
+			//spurious wakeup
+			continue;
+		}
 
+		profile_begin(Collision_eval_site);
 		thread_collision_vars[thread_num].collision->result = thread_collision_vars[thread_num].collision->eval_func(&(thread_collision_vars[thread_num].collision->objs), &temp_data);
+		profile_end(Collision_eval_site);
 
-		//we only care about the data if there is a collision
+		//we only care about the data if there is a collision; collision_pair_add() already made room for it
 		if(thread_collision_vars[thread_num].collision->result == COLLISION_RESULT_COLLISION) {
-			if(thread_collision_vars[thread_num].collision->exec_data == NULL) {
-				thread_collision_vars[thread_num].collision->exec_data = (collision_exec_data*)vm_malloc(sizeof(collision_exec_data));
-			}
+			Assert(thread_collision_vars[thread_num].collision->exec_data != NULL);
 			memcpy(thread_collision_vars[thread_num].collision->exec_data, &temp_data, sizeof(collision_exec_data));
 		}
-		else if (thread_collision_vars[thread_num].collision->exec_data != NULL) {
-			vm_free(thread_collision_vars[thread_num].collision->exec_data);
-			thread_collision_vars[thread_num].collision->exec_data = NULL;
-		}
 
 		thread_collision_vars[thread_num].collision->processed = PROCESS_STATE_COLLIDED;
 		thread_collision_vars[thread_num].collision = NULL;
@@ -609,6 +713,7 @@ int supercollider_thread(void *num)
 		Error(LOCATION, "supercollider mutex unlock failed: %s\n", SDL_GetError());
 	}
 
+	profile_thread_exit();
 	return 0;
 }
 
@@ -621,6 +726,10 @@ int collider_quicksort_thread(void *num)
 	int temp;
 	int store_index;
 	int i;
+	char name[32];
+
+	sprintf(name, "Quicksort Thread %d", thread_num);
+	profile_thread_name(name);
 
 	if (SDL_LockMutex(quicksort_queue_mutex) < 0) {
 		Error(LOCATION, "quicksort_queue_mutex lock failed: %s\n", SDL_GetError());
@@ -632,6 +741,7 @@ int collider_quicksort_thread(void *num)
 				Error(LOCATION, "quicksort_queue_mutex unlock failed: %s\n", SDL_GetError());
 			}
 			collision_quicksort_state[thread_num].status = PROCESS_STATE_EXECUTED;
+			profile_thread_exit();
 			return 0;
 		}
 
@@ -646,6 +756,7 @@ int collider_quicksort_thread(void *num)
 					Error(LOCATION, "quicksort_queue_mutex unlock failed: %s\n", SDL_GetError());
 				}
 				collision_quicksort_state[thread_num].status = PROCESS_STATE_EXECUTED;
+				profile_thread_exit();
 				return 0;
 			}
 		}
@@ -653,12 +764,27 @@ int collider_quicksort_thread(void *num)
 		vars.left = collision_quicksort_queue.front().left;
 		vars.right = collision_quicksort_queue.front().right;
 		vars.axis = collision_quicksort_queue.front().axis;
+		vars.job = collision_quicksort_queue.front().job;
 		collision_quicksort_state[thread_num].status = PROCESS_STATE_BUSY;
 		collision_quicksort_queue.pop();
 		if (SDL_UnlockMutex(quicksort_queue_mutex) < 0) {
 			Error(LOCATION, "quicksort_queue_mutex unlock failed: %s\n", SDL_GetError());
 		}
 
+		// a chunk from multithread_run_jobs() rather than a sort
+		if (vars.job != NULL) {
+			for (i = vars.left; i <= vars.right; i++) {
+				vars.job(i);
+			}
+
+			if (SDL_LockMutex(quicksort_queue_mutex) < 0) {
+				Error(LOCATION, "quicksort_queue_mutex lock failed: %s\n", SDL_GetError());
+			}
+			continue;
+		}
+
+		profile_begin(Collider_quicksort_site);
+
 		if (vars.right > vars.left) {
 			pivot_index = vars.left + (vars.right - vars.left) / 2;
 
@@ -688,10 +814,12 @@ int collider_quicksort_thread(void *num)
 			temp_vars_left.left = vars.left;
 			temp_vars_left.right = store_index - 1;
 			temp_vars_left.axis = vars.axis;
+			temp_vars_left.job = NULL;
 			temp_vars_right.list = vars.list;
 			temp_vars_right.left = store_index + 1;
 			temp_vars_right.right = vars.right;
 			temp_vars_right.axis = vars.axis;
+			temp_vars_right.job = NULL;
 			if (SDL_LockMutex(quicksort_queue_mutex) < 0) {
 				Error(LOCATION, "quicksort_queue_mutex lock failed: %s\n", SDL_GetError());
 			}
@@ -727,10 +855,13 @@ int collider_quicksort_thread(void *num)
 				Error(LOCATION, "quicksort_queue_mutex lock failed: %s\n", SDL_GetError());
 			}
 		}
+
+		profile_end(Collider_quicksort_site);
 	}
 	if (SDL_UnlockMutex(quicksort_queue_mutex) < 0) {
 		Error(LOCATION, "quicksort_queue_mutex unlock failed: %s\n", SDL_GetError());
 	}
 	collision_quicksort_state[thread_num].status = PROCESS_STATE_EXECUTED;
+	profile_thread_exit();
 	return 0;
 }
@@ -202,12 +202,15 @@ typedef struct
 	process_state status;
 } collider_quicksort_state;
 
+typedef void (*multithread_job_func)(int index);
+
 typedef struct
 {
 	SCP_vector<int> *list;
 	int left;
 	int right;
 	int axis;
+	multithread_job_func job;	// if set, job(left) .. job(right) are run instead of sorting list
 } collider_quicksort_vars;
 
 extern SDL_mutex *render_mutex;
@@ -229,6 +232,8 @@ extern SCP_vector<collider_quicksort_state> collision_quicksort_state;
 void create_threads();
 void destroy_threads();
 
+void multithread_run_jobs(multithread_job_func job, int count, int min_per_chunk);
+
 void evaluate_collisions();
 void execute_collisions();
 
@@ -24,6 +24,7 @@
 #include "mission/missionparse.h"
 #include "ship/ship.h"
 #include "cmdline/cmdline.h"
+#include "graphics/grbatch.h"
 
 
 // --------------------------------------------------------------------------------------------------------
@@ -38,6 +39,9 @@ static ubyte Neb2_fog_color_b = 0;
 
 static ubyte *Neb2_htl_fog_data = NULL;
 
+// stream buffer the player poofs are batched into
+static int Neb2_poof_buffer = -1;
+
 // #define NEB2_THUMBNAIL
 
 /*
@@ -385,6 +389,11 @@ void neb2_post_level_init()
 		}
 
 		Neb2_render_mode = NEB2_RENDER_HTL;
+
+		// grab a vertex buffer object for the poofs
+		if ( Neb2_poof_buffer < 0 ) {
+			Neb2_poof_buffer = gr_create_stream_buffer();
+		}
 	}
 
 	// load in all nebula bitmaps
@@ -904,6 +913,24 @@ DCF(max_area, "")
 }
 
 float g3_draw_rotated_bitmap_area(vertex *pnt, float angle, float rad, uint tmap_flags, float area);
+
+#define NEB2_POOF_TMAP_FLAGS	(TMAP_FLAG_TEXTURED | TMAP_FLAG_RGB | TMAP_FLAG_GOURAUD | TMAP_FLAG_ALPHA | TMAP_HTL_3D_UNLIT)
+
+// with GR_ALPHABLEND_FILTER a bitmap with an alpha channel is alpha blended and anything else is
+// added to the screen scaled by the alpha, so do the same through the vertex color
+static void neb2_set_poof_color(vertex *p, int bmap, float alpha)
+{
+	ubyte a = (ubyte)fl2i(MIN(alpha, 1.0f) * 255.0f);
+
+	if (bm_has_alpha_channel(bmap)) {
+		p->r = p->g = p->b = 255;
+		p->a = a;
+	} else {
+		p->r = p->g = p->b = a;
+		p->a = 255;
+	}
+}
+
 int neb_mode = 1;
 int frames_total = 0;
 int frame_count = 0;
@@ -914,7 +941,7 @@ void neb2_render_player()
 	int idx1, idx2, idx3;
 	float alpha;
 	int frame_rendered;	
-	vec3d eye_pos;
+	vec3d eye_pos, to_poof;
 	matrix eye_orient;
 
 	// standalone servers can bail here
@@ -1003,6 +1030,12 @@ void neb2_render_player()
 	}
 
 	frame_rendered = 0;
+
+	if (!Cmdline_nohtl) {
+		gr_set_lighting(false, false);
+	}
+	gr_fog_set(GR_FOGMODE_NONE, 0, 0, 0);
+
 	// render the nebula
 	for (idx1=0; idx1<Neb2_slices; idx1++) {
 		for (idx2=0; idx2<Neb2_slices; idx2++) {
@@ -1022,8 +1055,9 @@ void neb2_render_player()
 				}
 
 				// optimization 1 - don't draw backfacing poly's
-				// useless
-				if (vm_vec_dot_to_point(&eye_orient.vec.fvec, &eye_pos, &Neb2_cubes[idx1][idx2][idx3].pt) <= 0.0f) {
+				// only the sign matters, so there's no need to normalize
+				vm_vec_sub(&to_poof, &Neb2_cubes[idx1][idx2][idx3].pt, &eye_pos);
+				if (vm_vec_dot(&eye_orient.vec.fvec, &to_poof) <= 0.0f) {
 					pneb_tossed_dot++;
 					continue;
 				}
@@ -1064,17 +1098,29 @@ void neb2_render_player()
 					continue;
 				}
 
-				// set the bitmap and render
-				gr_set_bitmap(Neb2_cubes[idx1][idx2][idx3].bmap, GR_ALPHABLEND_FILTER, GR_BITBLT_MODE_NORMAL, (alpha + Neb2_cubes[idx1][idx2][idx3].flash));
+				alpha += Neb2_cubes[idx1][idx2][idx3].flash;
 
-				if (!Cmdline_nohtl) gr_set_lighting(false, false); {
-					gr_fog_set(GR_FOGMODE_NONE, 0, 0, 0);
+				if (Cmdline_nohtl) {
+					// set the bitmap and render
+					gr_set_bitmap(Neb2_cubes[idx1][idx2][idx3].bmap, GR_ALPHABLEND_FILTER, GR_BITBLT_MODE_NORMAL, alpha);
 					g3_draw_rotated_bitmap(&p, fl_radians(Neb2_cubes[idx1][idx2][idx3].rot), Nd->prad, TMAP_FLAG_TEXTURED);
+				} else {
+					// batch it up with the other poofs using this bitmap, passing the alpha along in the
+					// vertex color the same way GR_ALPHABLEND_FILTER would have applied it
+					neb2_set_poof_color(&p, Neb2_cubes[idx1][idx2][idx3].bmap, alpha);
+					g3_transfer_vertex(&p, &Neb2_cubes[idx1][idx2][idx3].pt);
+
+					batch_add_bitmap_rotated(Neb2_cubes[idx1][idx2][idx3].bmap, NEB2_POOF_TMAP_FLAGS, &p, fl_radians(Neb2_cubes[idx1][idx2][idx3].rot), Nd->prad);
+					frame_rendered++;
 				}
 			}
 		}
 	}
 
+	if (frame_rendered) {
+		batch_render_all(Neb2_poof_buffer);
+	}
+
 	frames_total += frame_rendered;
 	frame_count++;
 	frame_avg = (float)frames_total / (float)frame_count;
@@ -41,6 +41,7 @@
 #include "mission/missiongoals.h"
 #include "network/multi_log.h"
 #include "network/multi_rate.h"
+#include "network/multi_metrics.h"
 #include "hud/hudescort.h"
 #include "hud/hudmessage.h"
 #include "globalincs/alphacolors.h"
@@ -943,6 +944,9 @@ void multi_process_bigdata(ubyte *data, int len, net_addr *from_addr, int reliab
 	// check to see if netplayer is null (it may be in cases such as getting lists of games from the tracker)
 	if(player_num >= 0){
 		Net_players[player_num].last_heard_time = timer_get_fixed_seconds();
+
+		multi_metrics_player_inc(player_num, MM_PLAYER_PACKETS_IN);
+		multi_metrics_player_inc(player_num, MM_PLAYER_BYTES_IN, len);
 	}
 
 	// store fields that were passed along in the message
@@ -1430,6 +1434,8 @@ void standalone_main_init()
 	// NETLOG
 	ml_string(NOX("Standalone server initializing"));
 
+	multi_tick_reset();
+
 	// read in config file
 	// multi_options_read_config();   
 #ifdef _WIN32
@@ -1592,15 +1598,128 @@ void standalone_main_init()
 
 void standalone_main_do()
 {
- 
-   Sleep(10);  // since nothing will really be going on here, we can afford to give some time
-               // back to the operating system.
-
-	// kind of a do-nothing spin state.
+	// kind of a do-nothing spin state. The time given back to the operating system is handled by
+	// multi_tick_wait(), which runs this state at the idle tick rate and wakes up when data arrives.
 	// The standalone will eventually move into the GS_STATE_MULTI_MISSION_SYNC state when a host connects and
 	// attempts to start a game
 }
 
+// --------------------------------------------------------------------------------
+// standalone tick scheduler
+//
+
+static fix Multi_tick_next = 0;							// when the next tick is due to start
+static fix Multi_tick_start = 0;							// when the current tick started
+static multi_tick_stats Multi_tick_stats;
+
+void multi_tick_reset()
+{
+	Multi_tick_next = 0;
+	Multi_tick_start = 0;
+	memset(&Multi_tick_stats, 0, sizeof(multi_tick_stats));
+}
+
+fix multi_tick_wait(int idle)
+{
+	int rate, ms;
+	fix period, now, late, wait_start;
+	uint missed;
+
+	rate = idle ? Multi_options_g.std_idle_framecap : Multi_options_g.std_framecap;
+	CLAMP(rate, 1, 120);
+	period = F1_0 / rate;
+
+	now = timer_get_fixed_seconds();
+
+	if ( (Multi_tick_next == 0) || (now < Multi_tick_start) ) {
+		// first tick, or the timer wrapped
+		Multi_tick_next = now;
+		Multi_tick_start = now;
+	}
+
+	Multi_tick_stats.last_work = f2fl(now - Multi_tick_start);
+	wait_start = now;
+
+	if (now < Multi_tick_next) {
+		// wait on the socket rather than a plain sleep so that an idle server can handle a new packet right away
+		while (now < Multi_tick_next) {
+			ms = fl2i(f2fl(Multi_tick_next - now) * 1000.0f);
+
+			if (ms <= 0) {
+				break;
+			}
+
+			if ( psnet_wait_for_data(ms) ) {
+				if (idle) {
+					Multi_tick_stats.early_wakes++;
+					now = timer_get_fixed_seconds();
+					Multi_tick_next = now;
+					break;
+				}
+
+				// in a mission the packet waits for the next tick, but the socket stays readable until then,
+				// so waiting on it again would just spin; sleep out the rest of the tick instead
+				now = timer_get_fixed_seconds();
+				ms = fl2i(f2fl(Multi_tick_next - now) * 1000.0f);
+
+				if (ms > 0) {
+					Sleep(ms);
+				}
+
+				now = timer_get_fixed_seconds();
+				break;
+			}
+
+			now = timer_get_fixed_seconds();
+		}
+	} else {
+		late = now - Multi_tick_next;
+		missed = (uint)(late / period);
+
+		if (late > 0) {
+			Multi_tick_stats.overruns++;
+		}
+
+		if (Multi_options_g.std_tick_overrun == MULTI_TICK_OVERRUN_CATCHUP) {
+			// keep the original schedule, but don't let a long stall turn into a burst of back-to-back ticks
+			if (missed > MULTI_TICK_MAX_CATCHUP) {
+				Multi_tick_stats.skipped += missed - MULTI_TICK_MAX_CATCHUP;
+				Multi_tick_next = now - (MULTI_TICK_MAX_CATCHUP * period);
+			}
+		} else {
+			Multi_tick_stats.skipped += missed;
+			Multi_tick_next = now;
+		}
+	}
+
+	Multi_tick_start = now;
+	Multi_tick_next += period;
+
+	// update the stats
+	Multi_tick_stats.ticks++;
+	Multi_tick_stats.rate = (float)rate;
+	Multi_tick_stats.last_wait = f2fl(now - wait_start);
+
+	if (Multi_tick_stats.ticks == 1) {
+		Multi_tick_stats.avg_work = Multi_tick_stats.last_work;
+	} else {
+		Multi_tick_stats.avg_work += (Multi_tick_stats.last_work - Multi_tick_stats.avg_work) * 0.05f;
+	}
+
+	if (Multi_tick_stats.last_work > Multi_tick_stats.max_work) {
+		Multi_tick_stats.max_work = Multi_tick_stats.last_work;
+	}
+
+	return now;
+}
+
+void multi_tick_get_stats(multi_tick_stats *stats)
+{
+	Assert(stats != NULL);
+
+	*stats = Multi_tick_stats;
+}
+
 // --------------------------------------------------------------------------------
 // standalone_main_close()
 //
@@ -60,9 +60,10 @@ class player;
 // version 46 - 8/30/99
 // version 47 - 11/11/2003 (FS2OpenPXO, FS2 Open Changes - FS2Open 3.6)
 // revert  46 - 9/7/2006 (the 47 bump wasn't needed, reverting to retail version for compatibility reasons)
+// version 148 - 10/19/2026 (windowed, compressed and resumable file xfers)
 // STANDALONE_ONLY
 
-#define MULTI_FS_SERVER_VERSION							147
+#define MULTI_FS_SERVER_VERSION							148
 
 #define MULTI_FS_SERVER_COMPATIBLE_VERSION			MULTI_FS_SERVER_VERSION
 
@@ -870,4 +871,31 @@ void multi_standalone_postgame_do();
 void multi_standalone_postgame_close();
 
 
+// standalone tick scheduler -------------------
+
+#define MULTI_TICK_MAX_CATCHUP				3				// never try to catch up more than this many ticks
+
+typedef struct multi_tick_stats {
+	uint	ticks;											// ticks run since the last reset
+	uint	overruns;										// ticks which ran past their deadline
+	uint	skipped;											// whole ticks dropped to get back on schedule
+	uint	early_wakes;									// idle waits cut short by incoming network data
+	float	rate;												// tick rate used for the last tick
+	float	last_work;										// seconds spent inside the last tick
+	float	last_wait;										// seconds spent waiting before the last tick
+	float	avg_work;										// running average of last_work
+	float	max_work;										// worst last_work since the last reset
+} multi_tick_stats;
+
+// reset the tick schedule and statistics
+void multi_tick_reset();
+
+// wait for the start of the next standalone tick and return the time it started. idle ticks run at the
+// idle tick rate and also start as soon as network data arrives
+fix multi_tick_wait(int idle);
+
+// get the timing statistics of the standalone ticks
+void multi_tick_get_stats(multi_tick_stats *stats);
+
+
 #endif
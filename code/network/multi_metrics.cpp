@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) Freespace Open 2026.  All rights reserved.
+ *
+ * All source code herein is the property of Freespace Open. You may not sell
+ * or otherwise commercially exploit the source or things you created based on the
+ * source.
+ *
+*/
+
+
+
+#include "network/multi_metrics.h"
+#include "network/multi.h"
+#include "object/object.h"
+#include "globalincs/linklist.h"
+#include "freespace2/freespace.h"
+
+#include "SDL_atomic.h"
+
+
+// -----------------------------------------------------------------------------------------------------------------------
+// MULTI METRICS DEFINES/VARS
+//
+
+#define MM_MAX_THREADS								32
+#define MM_MAX_BUCKETS								10
+
+// every thread that counts something claims one of these the first time and is the only writer to it from then on.
+// the reader sums all the blocks. 64 bit values can tear on 32 bit builds, which at worst shows one odd sample
+typedef struct mm_thread_block {
+	SDL_atomic_t used;
+	ulonglong counters[MM_NUM_COUNTERS];
+	ulonglong player[MAX_PLAYERS][MM_NUM_PLAYER_COUNTERS];
+	ulonglong buckets[MM_NUM_HISTOGRAMS][MM_MAX_BUCKETS + 1];		// not cumulative, the last one is +Inf
+	double sums[MM_NUM_HISTOGRAMS];
+} mm_thread_block;
+
+static mm_thread_block Mm_blocks[MM_MAX_THREADS];
+static SCP_THREAD_LOCAL mm_thread_block *Mm_thread_block = NULL;
+
+typedef struct mm_metric_info {
+	const char *name;
+	const char *help;
+} mm_metric_info;
+
+static mm_metric_info Mm_counter_info[MM_NUM_COUNTERS] = {
+	{ "fs2_collision_pairs_total",			"Object pairs checked for collisions." },
+	{ "fs2_reliable_retransmits_total",	"Reliable packets sent again after no ack." },
+	{ "fs2_oo_updates_sent_total",			"Object updates sent to players." },
+	{ "fs2_oo_updates_skipped_total",		"Object updates skipped because they were not due yet." },
+};
+
+static mm_metric_info Mm_player_info[MM_NUM_PLAYER_COUNTERS] = {
+	{ "fs2_player_packets_received_total",	"Packets received from a player." },
+	{ "fs2_player_packets_sent_total",		"Packets sent to a player." },
+	{ "fs2_player_bytes_received_total",	"Bytes received from a player." },
+	{ "fs2_player_bytes_sent_total",			"Bytes sent to a player." },
+};
+
+typedef struct mm_histogram_info {
+	const char *name;
+	const char *help;
+	int num_bounds;
+	float bounds[MM_MAX_BUCKETS];
+} mm_histogram_info;
+
+static mm_histogram_info Mm_histogram_info[MM_NUM_HISTOGRAMS] = {
+	{ "fs2_frame_time_seconds",			"Frame time.",											9, { 0.005f, 0.01f, 0.02f, 0.033f, 0.05f, 0.1f, 0.25f, 0.5f, 1.0f } },
+	{ "fs2_sexp_eval_time_seconds",		"Time spent evaluating mission goals and events per frame.",	8, { 0.0001f, 0.0005f, 0.001f, 0.0025f, 0.005f, 0.01f, 0.025f, 0.05f } },
+};
+
+// gauges, only written by the game thread in multi_metrics_frame(). they're read by whichever thread renders
+// the metrics, so both sides hold Mm_gauge_lock while they touch them
+typedef struct mm_gauges {
+	int objects[MAX_OBJECT_TYPES];
+	int player_connected[MAX_PLAYERS];
+	int player_id[MAX_PLAYERS];
+	int player_ping[MAX_PLAYERS];
+} mm_gauges;
+
+static mm_gauges Mm_gauges;
+static SDL_SpinLock Mm_gauge_lock = 0;
+
+
+// -----------------------------------------------------------------------------------------------------------------------
+// MULTI METRICS FUNCTIONS
+//
+
+static mm_thread_block *multi_metrics_block()
+{
+	int idx;
+
+	if (Mm_thread_block != NULL) {
+		return Mm_thread_block;
+	}
+
+	for (idx = 0; idx < MM_MAX_THREADS; idx++) {
+		if (SDL_AtomicCAS(&Mm_blocks[idx].used, 0, 1)) {
+			Mm_thread_block = &Mm_blocks[idx];
+			return Mm_thread_block;
+		}
+	}
+
+	// out of blocks, share the last one. concurrent increments can then get lost, but nothing worse
+	Mm_thread_block = &Mm_blocks[MM_MAX_THREADS - 1];
+	return Mm_thread_block;
+}
+
+void multi_metrics_inc(int counter, int amount)
+{
+	Assert((counter >= 0) && (counter < MM_NUM_COUNTERS));
+
+	multi_metrics_block()->counters[counter] += amount;
+}
+
+void multi_metrics_player_inc(int np_index, int counter, int amount)
+{
+	Assert((counter >= 0) && (counter < MM_NUM_PLAYER_COUNTERS));
+
+	if ((np_index < 0) || (np_index >= MAX_PLAYERS)) {
+		return;
+	}
+
+	multi_metrics_block()->player[np_index][counter] += amount;
+}
+
+void multi_metrics_observe(int histogram, float value)
+{
+	mm_thread_block *block;
+	mm_histogram_info *info;
+	int idx;
+
+	Assert((histogram >= 0) && (histogram < MM_NUM_HISTOGRAMS));
+
+	block = multi_metrics_block();
+	info = &Mm_histogram_info[histogram];
+
+	for (idx = 0; idx < info->num_bounds; idx++) {
+		if (value <= info->bounds[idx]) {
+			break;
+		}
+	}
+
+	block->buckets[histogram][idx]++;
+	block->sums[histogram] += value;
+}
+
+void multi_metrics_frame()
+{
+	mm_gauges gauges;
+	object *objp;
+	int idx;
+
+	multi_metrics_observe(MM_HIST_FRAME_TIME, flFrametime);
+
+	memset(&gauges, 0, sizeof(gauges));
+	for (objp = GET_FIRST(&obj_used_list); objp != END_OF_LIST(&obj_used_list); objp = GET_NEXT(objp)) {
+		if ((objp->type >= 0) && (objp->type < MAX_OBJECT_TYPES)) {
+			gauges.objects[(int)objp->type]++;
+		}
+	}
+
+	for (idx = 0; idx < MAX_PLAYERS; idx++) {
+		gauges.player_connected[idx] = MULTI_CONNECTED(Net_players[idx]) && (Net_player != &Net_players[idx]);
+		if (gauges.player_connected[idx]) {
+			gauges.player_id[idx] = Net_players[idx].player_id;
+			gauges.player_ping[idx] = Net_players[idx].s_info.ping.ping_avg;
+		}
+	}
+
+	SDL_AtomicLock(&Mm_gauge_lock);
+	memcpy(&Mm_gauges, &gauges, sizeof(gauges));
+	SDL_AtomicUnlock(&Mm_gauge_lock);
+}
+
+static void multi_metrics_header(SCP_string &out, const char *name, const char *help, const char *type)
+{
+	char line[256];
+
+	sprintf(line, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+	out += line;
+}
+
+void multi_metrics_render(SCP_string &out)
+{
+	ulonglong counters[MM_NUM_COUNTERS];
+	ulonglong player[MAX_PLAYERS][MM_NUM_PLAYER_COUNTERS];
+	ulonglong buckets[MM_NUM_HISTOGRAMS][MM_MAX_BUCKETS + 1];
+	double sums[MM_NUM_HISTOGRAMS];
+	mm_gauges gauges;
+	char line[256];
+	int idx, s_idx, b_idx;
+
+	SDL_AtomicLock(&Mm_gauge_lock);
+	memcpy(&gauges, &Mm_gauges, sizeof(gauges));
+	SDL_AtomicUnlock(&Mm_gauge_lock);
+
+	// sum up all the thread blocks
+	memset(counters, 0, sizeof(counters));
+	memset(player, 0, sizeof(player));
+	memset(buckets, 0, sizeof(buckets));
+	memset(sums, 0, sizeof(sums));
+
+	for (idx = 0; idx < MM_MAX_THREADS; idx++) {
+		mm_thread_block *block = &Mm_blocks[idx];
+
+		if (!SDL_AtomicGet(&block->used)) {
+			continue;
+		}
+
+		for (s_idx = 0; s_idx < MM_NUM_COUNTERS; s_idx++) {
+			counters[s_idx] += block->counters[s_idx];
+		}
+		for (s_idx = 0; s_idx < MAX_PLAYERS; s_idx++) {
+			for (b_idx = 0; b_idx < MM_NUM_PLAYER_COUNTERS; b_idx++) {
+				player[s_idx][b_idx] += block->player[s_idx][b_idx];
+			}
+		}
+		for (s_idx = 0; s_idx < MM_NUM_HISTOGRAMS; s_idx++) {
+			for (b_idx = 0; b_idx <= MM_MAX_BUCKETS; b_idx++) {
+				buckets[s_idx][b_idx] += block->buckets[s_idx][b_idx];
+			}
+			sums[s_idx] += block->sums[s_idx];
+		}
+	}
+
+	out.clear();
+
+	// counters
+	for (idx = 0; idx < MM_NUM_COUNTERS; idx++) {
+		multi_metrics_header(out, Mm_counter_info[idx].name, Mm_counter_info[idx].help, "counter");
+		sprintf(line, "%s %llu\n", Mm_counter_info[idx].name, (unsigned long long)counters[idx]);
+		out += line;
+	}
+
+	// histograms
+	for (idx = 0; idx < MM_NUM_HISTOGRAMS; idx++) {
+		mm_histogram_info *info = &Mm_histogram_info[idx];
+		ulonglong total = 0;
+
+		multi_metrics_header(out, info->name, info->help, "histogram");
+		for (b_idx = 0; b_idx < info->num_bounds; b_idx++) {
+			total += buckets[idx][b_idx];
+			sprintf(line, "%s_bucket{le=\"%g\"} %llu\n", info->name, info->bounds[b_idx], (unsigned long long)total);
+			out += line;
+		}
+		total += buckets[idx][info->num_bounds];
+		sprintf(line, "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %f\n%s_count %llu\n", info->name, (unsigned long long)total, info->name, sums[idx], info->name, (unsigned long long)total);
+		out += line;
+	}
+
+	// objects
+	multi_metrics_header(out, "fs2_objects", "Objects in the mission by type.", "gauge");
+	for (idx = 0; idx < MAX_OBJECT_TYPES; idx++) {
+		sprintf(line, "fs2_objects{type=\"%s\"} %d\n", Object_type_names[idx], gauges.objects[idx]);
+		out += line;
+	}
+
+	// players, labelled by Net_players slot so the counters stay monotonic as players come and go
+	multi_metrics_header(out, "fs2_player_connected", "Whether a player slot is in use, with the player id.", "gauge");
+	for (idx = 0; idx < MAX_PLAYERS; idx++) {
+		if (gauges.player_connected[idx]) {
+			sprintf(line, "fs2_player_connected{slot=\"%d\",id=\"%d\"} 1\n", idx, gauges.player_id[idx]);
+			out += line;
+		}
+	}
+
+	multi_metrics_header(out, "fs2_player_ping_ms", "Average ping of a player.", "gauge");
+	for (idx = 0; idx < MAX_PLAYERS; idx++) {
+		if (gauges.player_connected[idx]) {
+			sprintf(line, "fs2_player_ping_ms{slot=\"%d\"} %d\n", idx, gauges.player_ping[idx]);
+			out += line;
+		}
+	}
+
+	for (s_idx = 0; s_idx < MM_NUM_PLAYER_COUNTERS; s_idx++) {
+		multi_metrics_header(out, Mm_player_info[s_idx].name, Mm_player_info[s_idx].help, "counter");
+		for (idx = 0; idx < MAX_PLAYERS; idx++) {
+			sprintf(line, "%s{slot=\"%d\"} %llu\n", Mm_player_info[s_idx].name, idx, (unsigned long long)player[idx][s_idx]);
+			out += line;
+		}
+	}
+}
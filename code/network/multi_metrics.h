@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) Freespace Open 2026.  All rights reserved.
+ *
+ * All source code herein is the property of Freespace Open. You may not sell
+ * or otherwise commercially exploit the source or things you created based on the
+ * source.
+ *
+*/
+
+
+
+#ifndef _MULTI_METRICS_HEADER_FILE
+#define _MULTI_METRICS_HEADER_FILE
+
+#include "globalincs/pstypes.h"
+
+// -----------------------------------------------------------------------------------------------------------------------
+// MULTI METRICS DEFINES/VARS
+//
+
+// counters
+#define MM_COUNTER_COLLISION_PAIRS				0			// object pairs handed to the collision code
+#define MM_COUNTER_RELIABLE_RETRANSMITS		1			// psnet2 reliable packets sent again
+#define MM_COUNTER_OO_SENT							2			// object updates packed for a player
+#define MM_COUNTER_OO_SKIPPED						3			// object updates not due yet for a player
+#define MM_NUM_COUNTERS								4
+
+// per player counters
+#define MM_PLAYER_PACKETS_IN						0
+#define MM_PLAYER_PACKETS_OUT						1
+#define MM_PLAYER_BYTES_IN							2
+#define MM_PLAYER_BYTES_OUT						3
+#define MM_NUM_PLAYER_COUNTERS					4
+
+// histograms
+#define MM_HIST_FRAME_TIME							0			// seconds
+#define MM_HIST_SEXP_EVAL_TIME					1			// seconds spent evaluating goals and events per frame
+#define MM_NUM_HISTOGRAMS							2
+
+// -----------------------------------------------------------------------------------------------------------------------
+// MULTI METRICS FUNCTIONS
+//
+
+// these can be called from any thread, each thread counts into its own block so there are no locks or atomics on the way in
+void multi_metrics_inc(int counter, int amount = 1);
+void multi_metrics_player_inc(int np_index, int counter, int amount = 1);
+void multi_metrics_observe(int histogram, float value);
+
+// sample the gauges (objects by type, players), call once per frame from the game thread
+void multi_metrics_frame();
+
+// render everything in the Prometheus text format, can be called from any thread. the gauges are copied under a lock,
+// the counters are summed without one, so they can be a little behind (or torn on 32 bit builds)
+void multi_metrics_render(SCP_string &out);
+
+#endif
@@ -18,6 +18,7 @@
 #include "network/multiutil.h"
 #include "network/multi_options.h"
 #include "network/multi_rate.h"
+#include "network/multi_metrics.h"
 #include "network/multi.h"
 #include "object/object.h"
 #include "ship/ship.h"
@@ -1107,6 +1108,7 @@ int multi_oo_maybe_update(net_player *pl, object *obj, ubyte *data)
 
 	// stamp hasn't popped yet
 	if((stamp != -1) && !timestamp_elapsed_safe(stamp, OO_MAX_TIMESTAMP)){
+		multi_metrics_inc(MM_COUNTER_OO_SKIPPED);
 		return 0;
 	}
 	
@@ -1226,6 +1228,8 @@ int multi_oo_maybe_update(net_player *pl, object *obj, ubyte *data)
 	// increment sequence #
 	Ships[obj->instance].np_updates[NET_PLAYER_NUM(pl)].seq++;
 
+	multi_metrics_inc(MM_COUNTER_OO_SENT);
+
 	// bytes packed
 	return packed;
 }
@@ -1425,6 +1429,9 @@ void multi_oo_gameplay_init()
 		}
 	//}			
 
+	// ship positions from a previous mission are no use for lag compensation
+	multi_oo_history_reset();
+
 	// reset datarate stamp now
 	extern int OO_gran;
 	for(idx=0; idx<MAX_PLAYERS; idx++){
@@ -1585,6 +1592,176 @@ void multi_oo_client_process();
 void multi_oo_update_server_rate();
 
 
+// ---------------------------------------------------------------------------------------------------
+// LAG COMPENSATION FUNCTIONS
+//
+
+typedef struct oo_history_frame {
+	int		stamp;										// timer_get_milliseconds() when this was recorded
+	vec3d		pos;
+	matrix	orient;
+} oo_history_frame;
+
+typedef struct oo_history {
+	int					signature;						// signature of the object this history belongs to
+	int					head;								// most recently recorded frame
+	int					count;							// number of valid frames
+	oo_history_frame	frames[OO_HISTORY_SIZE];
+} oo_history;
+
+oo_history Oo_history[MAX_SHIPS];
+
+void multi_oo_history_reset()
+{
+	int idx;
+
+	for (idx = 0; idx < MAX_SHIPS; idx++) {
+		Oo_history[idx].signature = -1;
+		Oo_history[idx].head = -1;
+		Oo_history[idx].count = 0;
+	}
+}
+
+void multi_oo_history_record()
+{
+	ship_obj *so;
+	object *objp;
+	oo_history *hist;
+	int stamp;
+
+	if ( !MULTIPLAYER_MASTER || !Multi_options_g.lag_compensation ) {
+		return;
+	}
+
+	stamp = timer_get_milliseconds();
+
+	for ( so = GET_FIRST(&Ship_obj_list); so != END_OF_LIST(&Ship_obj_list); so = GET_NEXT(so) ) {
+		objp = &Objects[so->objnum];
+
+		if ( (objp->instance < 0) || (objp->instance >= MAX_SHIPS) ) {
+			continue;
+		}
+
+		hist = &Oo_history[objp->instance];
+
+		// ship slot was reused, start over
+		if (hist->signature != objp->signature) {
+			hist->signature = objp->signature;
+			hist->head = -1;
+			hist->count = 0;
+		}
+
+		// frames are kept at least OO_HISTORY_INTERVAL apart so the ring always reaches back OO_LAG_COMP_MAX_REWIND,
+		// however fast we're running.  until then the latest frame is just brought up to date
+		if ( (hist->count == 0) || ((stamp - hist->frames[hist->head].stamp) >= OO_HISTORY_INTERVAL) ) {
+			hist->head = (hist->head + 1) % OO_HISTORY_SIZE;
+
+			if (hist->count < OO_HISTORY_SIZE) {
+				hist->count++;
+			}
+		}
+
+		hist->frames[hist->head].stamp = stamp;
+		hist->frames[hist->head].pos = objp->pos;
+		hist->frames[hist->head].orient = objp->orient;
+	}
+}
+
+int multi_oo_lag_comp_rewind(object *ship_objp, object *weapon_objp, vec3d *pos, matrix *orient)
+{
+	oo_history *hist;
+	oo_history_frame *newer, *older;
+	vec3d delta;
+	int player_index, rewind, target_stamp, idx, frame;
+	float t;
+
+	if ( !MULTIPLAYER_MASTER || !Multi_options_g.lag_compensation ) {
+		return 0;
+	}
+
+	if ( (ship_objp->instance < 0) || (ship_objp->instance >= MAX_SHIPS) ) {
+		return 0;
+	}
+
+	// only weapons fired by a client's own ship are compensated
+	if ( (weapon_objp->parent < 0) || (Objects[weapon_objp->parent].signature != weapon_objp->parent_sig) ) {
+		return 0;
+	}
+
+	if ( weapon_objp->parent == OBJ_INDEX(ship_objp) ) {
+		return 0;
+	}
+
+	player_index = multi_find_player_by_object(&Objects[weapon_objp->parent]);
+
+	if ( (player_index < 0) || (&Net_players[player_index] == Net_player) ) {
+		return 0;
+	}
+
+	rewind = Net_players[player_index].s_info.ping.ping_avg;
+	CLAMP(rewind, 0, OO_LAG_COMP_MAX_REWIND);
+
+	if (rewind <= 0) {
+		return 0;
+	}
+
+	hist = &Oo_history[ship_objp->instance];
+
+	if ( (hist->signature != ship_objp->signature) || (hist->count < 2) ) {
+		return 0;
+	}
+
+	target_stamp = hist->frames[hist->head].stamp - rewind;
+
+	// walk back from the newest frame until we find the two frames around the time the client saw
+	newer = &hist->frames[hist->head];
+	older = NULL;
+
+	for (idx = 1; idx < hist->count; idx++) {
+		frame = (hist->head - idx + OO_HISTORY_SIZE) % OO_HISTORY_SIZE;
+		older = &hist->frames[frame];
+
+		if (older->stamp <= target_stamp) {
+			break;
+		}
+
+		newer = older;
+	}
+
+	Assert(older != NULL);
+
+	// not enough history, so use the oldest we have
+	if ( (older->stamp > target_stamp) || (newer->stamp <= older->stamp) ) {
+		*pos = older->pos;
+		*orient = older->orient;
+		return 1;
+	}
+
+	t = i2fl(target_stamp - older->stamp) / i2fl(newer->stamp - older->stamp);
+
+	vm_vec_sub(&delta, &newer->pos, &older->pos);
+	vm_vec_scale_add(pos, &older->pos, &delta, t);
+
+	for (idx = 0; idx < 9; idx++) {
+		orient->a1d[idx] = older->orient.a1d[idx] + ((newer->orient.a1d[idx] - older->orient.a1d[idx]) * t);
+	}
+	vm_orthogonalize_matrix(orient);
+
+	return 1;
+}
+
+void multi_oo_lag_comp_restore(object *ship_objp, vec3d *rewound_pos, matrix *rewound_orient, vec3d *hit_point)
+{
+	vec3d world_offset, local;
+
+	Assert(hit_point != NULL);
+
+	vm_vec_sub(&world_offset, hit_point, rewound_pos);
+	vm_vec_rotate(&local, &world_offset, rewound_orient);
+	vm_vec_unrotate(hit_point, &local, &ship_objp->orient);
+	vm_vec_add2(hit_point, &ship_objp->pos);
+}
+
 // ---------------------------------------------------------------------------------------------------
 // DATARATE FUNCTIONS
 //
@@ -71,6 +71,33 @@ int multi_oo_is_interp_object(object *objp);
 void multi_oo_interp(object *objp);
 
 
+// ---------------------------------------------------------------------------------------------------
+// LAG COMPENSATION DEFINES/VARS
+//
+
+#define OO_LAG_COMP_MAX_REWIND			500				// never rewind a ship further than this many ms
+#define OO_HISTORY_INTERVAL				5					// ms between history frames, a newer frame replaces the latest until it's this old
+#define OO_HISTORY_SIZE						((OO_LAG_COMP_MAX_REWIND / OO_HISTORY_INTERVAL) + 2)	// enough frames to cover the rewind cap at any frame rate
+
+
+// ---------------------------------------------------------------------------------------------------
+// LAG COMPENSATION FUNCTIONS
+//
+
+// clear the position history of all ships
+void multi_oo_history_reset();
+
+// server only - store where all ships are this frame. call after movement and before collision detection
+void multi_oo_history_record();
+
+// server only - if the weapon was fired by a client, get where the ship was when that client saw it fire.
+// returns 1 if pos/orient were rewound, 0 if the current position should be used
+int multi_oo_lag_comp_rewind(object *ship_objp, object *weapon_objp, vec3d *pos, matrix *orient);
+
+// move a world hit point found against a rewound ship back onto the ship where it is now
+void multi_oo_lag_comp_restore(object *ship_objp, vec3d *rewound_pos, matrix *rewound_orient, vec3d *hit_point);
+
+
 // ---------------------------------------------------------------------------------------------------
 // DATARATE DEFINES/VARS
 //
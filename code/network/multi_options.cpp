@@ -180,6 +180,35 @@ void multi_options_read_config()
 						strncpy(Multi_options_g.std_pxo_password, tok, MULTI_TRACKER_STRING_LEN);
 					}
 				} else
+				// standalone simulation tick rate
+				if ( SETTING("+tick_rate") ) {
+					NEXT_TOKEN();
+					if (tok != NULL) {
+						if ( (atoi(tok) >= 1) && (atoi(tok) <= 120) ) {
+							Multi_options_g.std_framecap = atoi(tok);
+						}
+					}
+				} else
+				// standalone tick rate while no game is running
+				if ( SETTING("+idle_tick_rate") ) {
+					NEXT_TOKEN();
+					if (tok != NULL) {
+						if ( (atoi(tok) >= 1) && (atoi(tok) <= 120) ) {
+							Multi_options_g.std_idle_framecap = atoi(tok);
+						}
+					}
+				} else
+				// what to do when a tick runs too long
+				if ( SETTING("+tick_overrun") ) {
+					NEXT_TOKEN();
+					if (tok != NULL) {
+						if ( !stricmp(tok, "catchup") ) {
+							Multi_options_g.std_tick_overrun = MULTI_TICK_OVERRUN_CATCHUP;
+						} else if ( !stricmp(tok, "skip") ) {
+							Multi_options_g.std_tick_overrun = MULTI_TICK_OVERRUN_SKIP;
+						}
+					}
+				} else
 				if ( SETTING("+webui_root") ) {
 					NEXT_TOKEN();
 					if (tok != NULL) {
@@ -218,6 +247,10 @@ void multi_options_read_config()
 
 			// ... common to all modes ...
 
+			// rewind ships by the shooter's ping when checking weapon hits (only matters for the server)
+			if ( SETTING("+lag_compensation") ) {
+				Multi_options_g.lag_compensation = 1;
+			} else
 			// ip addr of user tracker
 			if ( SETTING("+user_server") ) {
 				NEXT_TOKEN();
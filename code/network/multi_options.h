@@ -19,6 +19,10 @@
 #define OBJ_UPDATE_HIGH								2					// high object updates
 #define OBJ_UPDATE_LAN								3					// ultra-high updates - no capping at all
 
+// what the standalone does when a tick runs longer than the tick period
+#define MULTI_TICK_OVERRUN_SKIP						0					// drop the lost ticks and schedule the next one from now
+#define MULTI_TICK_OVERRUN_CATCHUP					1					// keep the schedule and shorten the following waits until caught up
+
 struct header;
 struct netgame_info;
 struct net_player;
@@ -33,6 +37,7 @@ typedef struct multi_global_options {
 	ushort	port;															// port we're running on - for allowing multiple servers on one machine
 	int		log;															// use a logfile	
 	int		datarate_cap;												// datarate cap for OBJ_UPDATE_HIGH
+	int		lag_compensation;										// server checks client weapon hits against where the client saw its target
 
 	char		user_tracker_ip[MULTI_OPTIONS_STRING_LEN];		// ip address of user tracker
 	char		game_tracker_ip[MULTI_OPTIONS_STRING_LEN];		// ip address of game tracker
@@ -52,7 +57,9 @@ typedef struct multi_global_options {
 	char		std_pname[STD_NAME_LEN+1];								// permanent name for the standalone - if any
 	char		std_pxo_login[MULTI_OPTIONS_STRING_LEN];				// pxo login to use
 	char		std_pxo_password[MULTI_OPTIONS_STRING_LEN];				// pxo password to use
-	int		std_framecap;												// standalone frame cap
+	int		std_framecap;												// standalone frame cap (simulation tick rate)
+	int		std_idle_framecap;										// standalone tick rate while no game is running
+	int		std_tick_overrun;											// some MULTI_TICK_OVERRUN_* value
 
 	ushort		webapiPort;
 	SCP_string	webapiUsername;
@@ -66,6 +73,7 @@ typedef struct multi_global_options {
 
 		log = 0;
 		datarate_cap = 11000;//OO_HIGH_RATE_DEFAULT;
+		lag_compensation = 0;
 		strcpy_s(user_tracker_ip, "");
 		strcpy_s(game_tracker_ip, "");
 		strcpy_s(tracker_port, "");
@@ -82,6 +90,8 @@ typedef struct multi_global_options {
 		memset(std_passwd, 0, STD_PASSWD_LEN+1);
 		memset(std_pname, 0, STD_NAME_LEN+1);
 		std_framecap = 30;
+		std_idle_framecap = 10;
+		std_tick_overrun = MULTI_TICK_OVERRUN_SKIP;
 
 		webapiPort = 8080;
 		webapiUsername = "admin";
@@ -17,6 +17,8 @@
 #include "io/timer.h"
 #include "cfile/cfile.h"
 
+#include <zlib.h>
+
 #ifndef NDEBUG
 #include "playerman/player.h"
 #include "network/multiutil.h"
@@ -40,6 +42,7 @@
 #define MULTI_XFER_CODE_HEADER				2				// file xfer header information follows, requires a HEADER_RESPONSE
 #define MULTI_XFER_CODE_DATA					3				// data block follows, requires an ack
 #define MULTI_XFER_CODE_FINAL					4				// indication from sender that xfer is complete, requires an ack
+#define MULTI_XFER_CODE_RESUME				5				// response to a header when the receiver already has part of the stream
 
 // entry flags
 #define MULTI_XFER_FLAG_USED					(1<<0)		// this entry is in use	
@@ -54,9 +57,15 @@
 #define MULTI_XFER_FLAG_TIMEOUT				(1<<9)		// xfer has timed-out
 #define MULTI_XFER_FLAG_QUEUE_CURRENT		(1<<10)		// for a set of XFER_FLAG_QUEUE'd files, this is the current one sending
 
+// stream flags (sent with the header)
+#define MULTI_XFER_STREAM_COMPRESSED			(1<<0)		// the stream is the zlib compressed file
+
 // packet size for file xfer
 #define MULTI_XFER_MAX_DATA_SIZE				490			// this will keep us within the MULTI_XFER_MAX_SIZE_LIMIT
 
+// max data blocks sent but not yet acked for a single xfer
+#define MULTI_XFER_WINDOW						8
+
 // timeout for a given xfer operation
 #define MULTI_XFER_TIMEOUT						10000		
 
@@ -75,8 +84,12 @@ typedef struct xfer_entry {
 	char ex_filename[MAX_FILENAME_LEN+10];					// filename with xfer prefix tacked on to the front
 	CFILE *file;													// file handle of the current xferring file
 	int file_size;													// total size of the file being xferred
-	int file_ptr;													// total bytes we're received so far
+	int file_ptr;													// total bytes of the stream we've sent/received so far
 	ushort file_chksum;											// used for checking successfully xferred files
+	ubyte *stream;													// sender only - the whole outgoing stream
+	int stream_size;												// size of the stream going over the wire (compressed size if compressed)
+	ubyte stream_flags;											// MULTI_XFER_STREAM_* flags
+	int in_flight;													// sender only - data blocks sent but not yet acked
 	PSNET_SOCKET_RELIABLE file_socket;						// socket used to xfer the file	
 	int xfer_stamp;												// timestamp for the current operation		
 	int force_dir;													// force the file to go to this directory on receive (will override Multi_xfer_force_dir)	
@@ -96,6 +109,21 @@ int Multi_xfer_force_dir;
 // unique file signature - this along with a socket # is enough to identify all xfers
 ushort Multi_xfer_sig = 0;
 
+// partially received streams we can resume, identified by filename and checksum. the partial data itself
+// stays in the prefixed temp file. these survive multi_xfer_init() so a player who drops and rejoins
+// doesn't have to start a big mission over
+#define MAX_XFER_PARTIALS						8
+typedef struct xfer_partial {
+	char filename[MAX_FILENAME_LEN+1];						// empty if this slot is free
+	ushort file_chksum;
+	int stream_size;
+	ubyte stream_flags;
+	int received;													// bytes of the stream in the temp file
+	int force_dir;
+} xfer_partial;
+xfer_partial Multi_xfer_partial[MAX_XFER_PARTIALS];
+int Multi_xfer_partial_next = 0;
+
 
 // ------------------------------------------------------------------------------------------
 // MULTI XFER FORWARD DECLARATIONS
@@ -123,11 +151,35 @@ void multi_xfer_process_final(xfer_entry *xe);
 void multi_xfer_process_data(xfer_entry *xe, ubyte *data, int data_size);
 	
 // process a header
-void multi_xfer_process_header(ubyte *data, PSNET_SOCKET_RELIABLE who, ushort sig, char *filename, int file_size, ushort file_checksum);		
+void multi_xfer_process_header(ubyte *data, PSNET_SOCKET_RELIABLE who, ushort sig, char *filename, int file_size, ushort file_checksum, ubyte stream_flags, int stream_size);
+
+// process a resume for this entry
+void multi_xfer_process_resume(xfer_entry *xe, int offset);
 
 // send the next block of outgoing data or a "final" packet if we're done
 void multi_xfer_send_next(xfer_entry *xe);
 
+// send as many blocks as the window allows
+void multi_xfer_fill_window(xfer_entry *xe);
+
+// send a resume to the sender
+void multi_xfer_send_resume(PSNET_SOCKET_RELIABLE socket, ushort sig, int offset);
+
+// read the file for an outgoing entry into its stream, compressing it if that helps
+int multi_xfer_build_stream(xfer_entry *xe);
+
+// free the outgoing stream of an entry
+void multi_xfer_free_stream(xfer_entry *xe);
+
+// turn a completely received compressed stream back into the file, return 1 on success
+int multi_xfer_inflate_stream(xfer_entry *xe);
+
+// remember the temp file of an incomplete receive so it can be resumed later
+void multi_xfer_save_partial(xfer_entry *xe);
+
+// find a resumable partial matching the header info, or NULL
+xfer_partial *multi_xfer_find_partial(char *filename, ushort file_chksum, int stream_size, ubyte stream_flags, int force_dir);
+
 // send an ack to the sender
 void multi_xfer_send_ack(PSNET_SOCKET_RELIABLE socket, ushort sig);
 
@@ -153,8 +205,8 @@ ushort multi_xfer_get_sig();
 // initialize all file xfer transaction stuff, call in multi_level_init()
 void multi_xfer_init(void (*multi_xfer_recv_callback)(int handle))
 {
-	// blast all the entries
-	memset(Multi_xfer_entry,0,sizeof(xfer_entry) * MAX_XFER_ENTRIES);
+	// blast all the entries, releasing the streams and files of any still left over from the last session
+	multi_xfer_reset();
 
 	// assign the receive callback function pointer
 	Multi_xfer_recv_notify = multi_xfer_recv_callback;
@@ -255,6 +307,21 @@ int multi_xfer_send_file(PSNET_SOCKET_RELIABLE who, char *filename, int cfile_fl
 	// rewind the file pointer to the beginning of the file
 	cfseek(temp_entry.file,0,CF_SEEK_SET);
 
+	// read in the whole file, we send it as a single (maybe compressed) stream
+	if(!multi_xfer_build_stream(&temp_entry)){
+#ifdef MULTI_XFER_VERBOSE
+		nprintf(("Network","MULTI XFER : Could not read file %s on xfer send\n",filename));
+#endif
+		cfclose(temp_entry.file);
+		return -1;
+	}
+	cfclose(temp_entry.file);
+	temp_entry.file = NULL;
+
+#ifdef MULTI_XFER_VERBOSE
+	nprintf(("Network","MULTI XFER : Sending file %s as %d bytes (%d bytes uncompressed)\n",temp_entry.filename,temp_entry.stream_size,temp_entry.file_size));
+#endif
+
 	// set the flags
 	temp_entry.flags |= (MULTI_XFER_FLAG_USED | MULTI_XFER_FLAG_SEND | MULTI_XFER_FLAG_PENDING);
 	temp_entry.flags |= flags;
@@ -317,17 +384,24 @@ void multi_xfer_abort(int handle)
 	// get e handle to the entry
 	xe = &Multi_xfer_entry[handle];
 
-	// close any open file and delete it 
+	// close any open file and delete it, unless we can pick up where we left off next time
 	if(xe->file != NULL){
 		cfclose(xe->file);
 		xe->file = NULL;
 
 		// delete it if there isn't some problem with the filename
 		if((xe->flags & MULTI_XFER_FLAG_RECV) && (xe->filename[0] != '\0')){
-			cf_delete(xe->ex_filename, xe->force_dir);
+			if(!(xe->flags & MULTI_XFER_FLAG_FAIL) && (xe->file_ptr > 0)){
+				multi_xfer_save_partial(xe);
+			} else {
+				cf_delete(xe->ex_filename, xe->force_dir);
+			}
 		}
 	}
 
+	// free any outgoing data
+	multi_xfer_free_stream(xe);
+
 	// zero the socket
 	xe->file_socket = INVALID_SOCKET;
 
@@ -353,12 +427,19 @@ void multi_xfer_release_handle(int handle)
 		cfclose(xe->file);
 		xe->file = NULL;
 
-		// delete it if the file was not successfully received
+		// delete it if the file was not successfully received, unless we can pick up where we left off next time
 		if(!(xe->flags & MULTI_XFER_FLAG_SUCCESS) && (xe->flags & MULTI_XFER_FLAG_RECV) && (xe->filename[0] != '\0')){
-			cf_delete(xe->ex_filename,xe->force_dir);
+			if(!(xe->flags & MULTI_XFER_FLAG_FAIL) && (xe->file_ptr > 0)){
+				multi_xfer_save_partial(xe);
+			} else {
+				cf_delete(xe->ex_filename,xe->force_dir);
+			}
 		}
 	}
 
+	// free any outgoing data
+	multi_xfer_free_stream(xe);
+
 	// zero the socket
 	xe->file_socket = INVALID_SOCKET;	
 
@@ -464,13 +545,13 @@ float multi_xfer_pct_complete(int handle)
 		return -1.0f;
 	}
 
-	// if the file size is 0, return invalid
-	if(Multi_xfer_entry[handle].file_size == 0){
+	// if the stream size is 0, return invalid
+	if(Multi_xfer_entry[handle].stream_size == 0){
 		return -1.0f;
 	}
 
 	// return the pct completion
-	return (float)Multi_xfer_entry[handle].file_ptr / (float)Multi_xfer_entry[handle].file_size;
+	return (float)Multi_xfer_entry[handle].file_ptr / (float)Multi_xfer_entry[handle].stream_size;
 }
 
 // get the socket of the file xfer (useful for identifying players)
@@ -614,6 +695,9 @@ void multi_xfer_fail_entry(xfer_entry *xe)
 	if((xe->flags & MULTI_XFER_FLAG_RECV) && (xe->filename[0] != '\0')){
 		cf_delete(xe->ex_filename,xe->force_dir);
 	}
+
+	// free any outgoing data
+	multi_xfer_free_stream(xe);
 		
 	// null the timestamp
 	xe->xfer_stamp = -1;
@@ -657,6 +741,9 @@ int multi_xfer_process_packet(unsigned char *data, PSNET_SOCKET_RELIABLE who)
 	ushort data_size = 0;
 	int file_size = -1;
 	ushort file_checksum = 0;
+	ubyte stream_flags = 0;
+	int stream_size = -1;
+	int resume_offset = 0;
 	int offset = 0;
 	ubyte xfer_data[600];
 	ushort sig;
@@ -679,6 +766,8 @@ int multi_xfer_process_packet(unsigned char *data, PSNET_SOCKET_RELIABLE who)
 		GET_STRING(filename);
 		GET_INT(file_size);					
 		GET_USHORT(file_checksum);
+		GET_DATA(stream_flags);
+		GET_INT(stream_size);
 		sender_side = 0;
 		break;
 
@@ -687,6 +776,11 @@ int multi_xfer_process_packet(unsigned char *data, PSNET_SOCKET_RELIABLE who)
 	case MULTI_XFER_CODE_NAK:
 		break;
 
+	// SEND side
+	case MULTI_XFER_CODE_RESUME:
+		GET_INT(resume_offset);
+		break;
+
 	// RECV side
 	case MULTI_XFER_CODE_FINAL:
 		sender_side = 0;
@@ -755,11 +849,17 @@ int multi_xfer_process_packet(unsigned char *data, PSNET_SOCKET_RELIABLE who)
 		Assert(xe != NULL);
 		multi_xfer_process_data(xe, xfer_data, data_size);
 		break;
+
+	// process a resume
+	case MULTI_XFER_CODE_RESUME :
+		Assert(xe != NULL);
+		multi_xfer_process_resume(xe, resume_offset);
+		break;
 	
 	// process a header
 	case MULTI_XFER_CODE_HEADER :
 		// send on my reliable socket
-		multi_xfer_process_header(xfer_data, who, sig, filename, file_size, file_checksum);
+		multi_xfer_process_header(xfer_data, who, sig, filename, file_size, file_checksum, stream_flags, stream_size);
 		break;
 	}		
 	return offset;
@@ -784,13 +884,39 @@ void multi_xfer_process_ack(xfer_entry *xe)
 				multi_xfer_release_handle(xe - Multi_xfer_entry);
 			}
 		} 
-		// otherwise if we're waiting for an ack, we should send the next chunk of data or a "final" packet if we're done
+		// otherwise if we're waiting for an ack, this either acks the header (nothing in flight yet) or one data block.
+		// either way we can fill the window back up, or send a "final" packet if we're done
 		else if(xe->flags & MULTI_XFER_FLAG_WAIT_ACK){
-			multi_xfer_send_next(xe);
+			if(xe->in_flight > 0){
+				xe->in_flight--;
+			}
+			multi_xfer_fill_window(xe);
 		}
 	}
 }
 
+// process a resume for this entry
+void multi_xfer_process_resume(xfer_entry *xe, int offset)
+{
+	// only valid as a response to our header
+	if(!(xe->flags & MULTI_XFER_FLAG_SEND) || !(xe->flags & MULTI_XFER_FLAG_WAIT_ACK) || (xe->in_flight > 0) || (xe->file_ptr > 0)){
+		return;
+	}
+
+	if((offset < 0) || (offset > xe->stream_size)){
+		multi_xfer_send_nak(xe->file_socket, xe->sig);
+		multi_xfer_fail_entry(xe);
+		return;
+	}
+
+#ifdef MULTI_XFER_VERBOSE
+	nprintf(("Network","MULTI XFER : Resuming send of %s at %d of %d bytes\n", xe->filename, offset, xe->stream_size));
+#endif
+
+	xe->file_ptr = offset;
+	multi_xfer_fill_window(xe);
+}
+
 // process a nak for this entry
 void multi_xfer_process_nak(xfer_entry *xe)
 {		
@@ -813,6 +939,20 @@ void multi_xfer_process_final(xfer_entry *xe)
 		xe->file = NULL;
 	}	
 
+	// a compressed stream has to be turned back into the real file first
+	if((xe->stream_flags & MULTI_XFER_STREAM_COMPRESSED) && !multi_xfer_inflate_stream(xe)){
+		// mark as failed
+		xe->flags |= MULTI_XFER_FLAG_FAIL;
+
+#ifdef MULTI_XFER_VERBOSE
+		nprintf(("Network","MULTI XFER : file %s failed to decompress!\n",xe->ex_filename));
+#endif
+
+		// abort the xfer
+		multi_xfer_abort(xe - Multi_xfer_entry);
+		return;
+	}
+
 	// check to make sure the file checksum is the same
 	chksum = 0;
 	if(!cf_chksum_short(xe->ex_filename, &chksum, -1, xe->force_dir) || (chksum != xe->file_chksum)){
@@ -867,7 +1007,7 @@ void multi_xfer_process_data(xfer_entry *xe, ubyte *data, int data_size)
 	nprintf(("Network","."));		
 
 	// attempt to write the rest of the data string to the file
-	if((xe->file == NULL) || !cfwrite(data, data_size, 1, xe->file)){
+	if((xe->file == NULL) || ((xe->file_ptr + data_size) > xe->stream_size) || !cfwrite(data, data_size, 1, xe->file)){
 		// inform the sender we had a problem
 		multi_xfer_send_nak(xe->file_socket, xe->sig);
 
@@ -889,9 +1029,10 @@ void multi_xfer_process_data(xfer_entry *xe, ubyte *data, int data_size)
 }
 	
 // process a header, return bytes processed
-void multi_xfer_process_header(ubyte *data, PSNET_SOCKET_RELIABLE who, ushort sig, char *filename, int file_size, ushort file_checksum)
+void multi_xfer_process_header(ubyte *data, PSNET_SOCKET_RELIABLE who, ushort sig, char *filename, int file_size, ushort file_checksum, ubyte stream_flags, int stream_size)
 {		
 	xfer_entry *xe;		
+	xfer_partial *xp;
 	int handle;	
 
 	// if the xfer system is locked, send a nak
@@ -919,6 +1060,10 @@ void multi_xfer_process_header(ubyte *data, PSNET_SOCKET_RELIABLE who, ushort si
 	// get the file chksum
 	xe->file_chksum = file_checksum;	
 
+	// get the stream info
+	xe->stream_flags = stream_flags;
+	xe->stream_size = stream_size;
+
 	// set the socket
 	xe->file_socket = who;	
 
@@ -955,9 +1100,25 @@ void multi_xfer_process_header(ubyte *data, PSNET_SOCKET_RELIABLE who, ushort si
 	cf_delete( xe->filename, CF_TYPE_MULTI_CACHE );
 	cf_delete( xe->filename, CF_TYPE_MISSIONS );
 
-	// attempt to open the file (using the prefixed filename)
+	// see if we already have the start of this exact stream from an earlier attempt
+	xp = multi_xfer_find_partial(xe->filename, xe->file_chksum, xe->stream_size, xe->stream_flags, xe->force_dir);
+	if(xp != NULL){
+		// make sure the temp file is still what we left behind
+		xe->file = cfopen(xe->ex_filename, "rb", CFILE_NORMAL, xe->force_dir);
+		if((xe->file != NULL) && (cfilelength(xe->file) == xp->received)){
+			xe->file_ptr = xp->received;
+		}
+		if(xe->file != NULL){
+			cfclose(xe->file);
+		}
+
+		// either way this partial is used up
+		xp->filename[0] = '\0';
+	}
+
+	// attempt to open the file (using the prefixed filename), appending if we are resuming
 	xe->file = NULL;
-	xe->file = cfopen(xe->ex_filename, "wb", CFILE_NORMAL, xe->force_dir);
+	xe->file = cfopen(xe->ex_filename, (xe->file_ptr > 0) ? "ab" : "wb", CFILE_NORMAL, xe->force_dir);
 	if(xe->file == NULL){		
 		multi_xfer_send_nak(who, sig);		
 
@@ -969,8 +1130,15 @@ void multi_xfer_process_header(ubyte *data, PSNET_SOCKET_RELIABLE who, ushort si
 	// set the waiting for data flag
 	xe->flags |= MULTI_XFER_FLAG_WAIT_DATA;		
 
-	// send an ack to the server		
-	multi_xfer_send_ack(who, sig);	
+	// tell the sender to start from the beginning, or from where we left off
+	if(xe->file_ptr > 0){
+#ifdef MULTI_XFER_VERBOSE
+		nprintf(("Network","MULTI XFER : Resuming receive of %s at %d of %d bytes\n", xe->filename, xe->file_ptr, xe->stream_size));
+#endif
+		multi_xfer_send_resume(who, sig, xe->file_ptr);
+	} else {
+		multi_xfer_send_ack(who, sig);	
+	}
 
 #ifdef MULTI_XFER_VERBOSE
 	nprintf(("Network","MULTI XFER : AFTER HEADER %s\n",xe->filename));
@@ -989,7 +1157,7 @@ void multi_xfer_send_next(xfer_entry *xe)
 	nprintf(("Network", "+"));		
 
 	// if we've sent all the data, then we should send a "final" packet
-	if(xe->file_ptr >= xe->file_size){
+	if(xe->file_ptr >= xe->stream_size){
 		// mark the entry as unknown 
 		xe->flags |= MULTI_XFER_FLAG_UNKNOWN;
 
@@ -1009,13 +1177,11 @@ void multi_xfer_send_next(xfer_entry *xe)
 	flen = strlen(xe->filename) + 4;
 
 	// determine how much data we are going to send with this packet and add it in
-	if((xe->file_size - xe->file_ptr) >= (MULTI_XFER_MAX_DATA_SIZE - flen)){
+	if((xe->stream_size - xe->file_ptr) >= (MULTI_XFER_MAX_DATA_SIZE - flen)){
 		data_size = (ushort)(MULTI_XFER_MAX_DATA_SIZE - flen);
 	} else {
-		data_size = (unsigned short)(xe->file_size - xe->file_ptr);
+		data_size = (unsigned short)(xe->stream_size - xe->file_ptr);
 	}
-	// increment the file pointer
-	xe->file_ptr += data_size;	
 
 	// add the opcode
 	code = MULTI_XFER_CODE_DATA;
@@ -1028,18 +1194,16 @@ void multi_xfer_send_next(xfer_entry *xe)
 	ADD_USHORT(data_size);
 	
 	// copy in the data
-	if(cfread(data+packet_size,1,(int)data_size,xe->file) == 0){
-		// send a nack to the receiver
-		multi_xfer_send_nak(xe->file_socket, xe->sig);
+	Assert(xe->stream != NULL);
+	memcpy(data+packet_size, xe->stream+xe->file_ptr, data_size);
 
-		// fail this send
-		multi_xfer_fail_entry(xe);		
-		return;
-	}
-
-	// increment the packet size
+	// increment the file pointer and the packet size
+	xe->file_ptr += data_size;
 	packet_size += (int)data_size;
 
+	// one more block waiting for an ack
+	xe->in_flight++;
+
 	// set the timestmp
 	xe->xfer_stamp = timestamp(MULTI_XFER_TIMEOUT);
 
@@ -1047,6 +1211,22 @@ void multi_xfer_send_next(xfer_entry *xe)
 	psnet_rel_send(xe->file_socket, data, packet_size);
 }
 
+// send as many blocks as the window allows
+void multi_xfer_fill_window(xfer_entry *xe)
+{
+	// once everything has been acked, send the "final" packet
+	if(xe->file_ptr >= xe->stream_size){
+		if(xe->in_flight == 0){
+			multi_xfer_send_next(xe);
+		}
+		return;
+	}
+
+	while((xe->in_flight < MULTI_XFER_WINDOW) && (xe->file_ptr < xe->stream_size) && (xe->flags & MULTI_XFER_FLAG_USED)){
+		multi_xfer_send_next(xe);
+	}
+}
+
 // send an ack to the sender
 void multi_xfer_send_ack(PSNET_SOCKET_RELIABLE socket, ushort sig)
 {
@@ -1087,6 +1267,29 @@ void multi_xfer_send_nak(PSNET_SOCKET_RELIABLE socket, ushort sig)
 	psnet_rel_send(socket, data, packet_size);
 }
 
+// send a resume to the sender
+void multi_xfer_send_resume(PSNET_SOCKET_RELIABLE socket, ushort sig, int offset)
+{
+	ubyte data[MAX_PACKET_SIZE],code;	
+	int packet_size = 0;
+
+	// build the header and add the code
+	BUILD_HEADER(XFER_PACKET);	
+
+	// add the opcode
+	code = MULTI_XFER_CODE_RESUME;
+	ADD_DATA(code);
+
+	// add the sig
+	ADD_USHORT(sig);
+
+	// add where to pick up from
+	ADD_INT(offset);
+
+	// send the data	
+	psnet_rel_send(socket, data, packet_size);
+}
+
 // send a "final" packet
 void multi_xfer_send_final(xfer_entry *xe)
 {
@@ -1130,6 +1333,10 @@ void multi_xfer_send_header(xfer_entry *xe)
 	// add the file checksum
 	ADD_USHORT(xe->file_chksum);
 
+	// add the stream info
+	ADD_DATA(xe->stream_flags);
+	ADD_INT(xe->stream_size);
+
 	// send the packet	
 	psnet_rel_send(xe->file_socket, data, packet_size);
 }
@@ -1166,3 +1373,159 @@ ushort multi_xfer_get_sig()
 
 	return ret;
 }
+
+// read the file for an outgoing entry into its stream, compressing it if that helps
+int multi_xfer_build_stream(xfer_entry *xe)
+{
+	ubyte *raw;
+	uLongf comp_size;
+
+	Assert(xe->file != NULL);
+	Assert(xe->stream == NULL);
+
+	raw = (ubyte*)vm_malloc(MAX(xe->file_size, 1));
+	if(raw == NULL){
+		return 0;
+	}
+
+	if((xe->file_size > 0) && (cfread(raw, 1, xe->file_size, xe->file) != xe->file_size)){
+		vm_free(raw);
+		return 0;
+	}
+
+	// mission files compress very well, but only use the compressed stream if it actually saves something
+	comp_size = compressBound((uLong)xe->file_size);
+	xe->stream = (ubyte*)vm_malloc(comp_size);
+	if((xe->stream != NULL) && (compress2(xe->stream, &comp_size, raw, (uLong)xe->file_size, Z_BEST_COMPRESSION) == Z_OK) && ((int)comp_size < xe->file_size)){
+		vm_free(raw);
+		xe->stream_size = (int)comp_size;
+		xe->stream_flags |= MULTI_XFER_STREAM_COMPRESSED;
+	} else {
+		if(xe->stream != NULL){
+			vm_free(xe->stream);
+		}
+		xe->stream = raw;
+		xe->stream_size = xe->file_size;
+		xe->stream_flags &= ~MULTI_XFER_STREAM_COMPRESSED;
+	}
+
+	return 1;
+}
+
+// free the outgoing stream of an entry
+void multi_xfer_free_stream(xfer_entry *xe)
+{
+	if(xe->stream != NULL){
+		vm_free(xe->stream);
+		xe->stream = NULL;
+	}
+}
+
+// turn a completely received compressed stream back into the file, return 1 on success
+int multi_xfer_inflate_stream(xfer_entry *xe)
+{
+	CFILE *cfp;
+	ubyte *comp, *raw;
+	uLongf raw_size;
+	int ok;
+
+	if((xe->stream_size <= 0) || (xe->file_size < 0)){
+		return 0;
+	}
+
+	// read the compressed stream back in
+	cfp = cfopen(xe->ex_filename, "rb", CFILE_NORMAL, xe->force_dir);
+	if(cfp == NULL){
+		return 0;
+	}
+
+	comp = (ubyte*)vm_malloc(xe->stream_size);
+	if(comp == NULL){
+		cfclose(cfp);
+		return 0;
+	}
+
+	ok = (cfread(comp, 1, xe->stream_size, cfp) == xe->stream_size);
+	cfclose(cfp);
+
+	// and inflate it
+	raw = NULL;
+	if(ok){
+		raw_size = (uLongf)xe->file_size;
+		raw = (ubyte*)vm_malloc(MAX(xe->file_size, 1));
+		ok = (raw != NULL) && (uncompress(raw, &raw_size, comp, (uLong)xe->stream_size) == Z_OK) && ((int)raw_size == xe->file_size);
+	}
+	vm_free(comp);
+
+	// replace the temp file with the real data
+	if(ok){
+		cfp = cfopen(xe->ex_filename, "wb", CFILE_NORMAL, xe->force_dir);
+		ok = (cfp != NULL) && ((xe->file_size == 0) || cfwrite(raw, xe->file_size, 1, cfp));
+		if(cfp != NULL){
+			cfclose(cfp);
+		}
+	}
+
+	if(raw != NULL){
+		vm_free(raw);
+	}
+
+	return ok;
+}
+
+// remember the temp file of an incomplete receive so it can be resumed later
+void multi_xfer_save_partial(xfer_entry *xe)
+{
+	xfer_partial *xp;
+	int idx;
+
+	// reuse any existing slot for this file, otherwise take the next one round-robin
+	xp = NULL;
+	for(idx=0; idx<MAX_XFER_PARTIALS; idx++){
+		if(!stricmp(Multi_xfer_partial[idx].filename, xe->filename)){
+			xp = &Multi_xfer_partial[idx];
+			break;
+		}
+	}
+	if(xp == NULL){
+		xp = &Multi_xfer_partial[Multi_xfer_partial_next];
+		Multi_xfer_partial_next = (Multi_xfer_partial_next + 1) % MAX_XFER_PARTIALS;
+
+		// the temp file of whatever we're replacing is no use anymore
+		if(xp->filename[0] != '\0'){
+			char ex_filename[MAX_FILENAME_LEN+10];
+
+			multi_xfer_conv_prefix(xp->filename, ex_filename);
+			cf_delete(ex_filename, xp->force_dir);
+		}
+	}
+
+	strcpy_s(xp->filename, xe->filename);
+	xp->file_chksum = xe->file_chksum;
+	xp->stream_size = xe->stream_size;
+	xp->stream_flags = xe->stream_flags;
+	xp->received = xe->file_ptr;
+	xp->force_dir = xe->force_dir;
+
+#ifdef MULTI_XFER_VERBOSE
+	nprintf(("Network","MULTI XFER : Keeping %d of %d bytes of %s to resume later\n", xp->received, xp->stream_size, xp->filename));
+#endif
+}
+
+// find a resumable partial matching the header info, or NULL
+xfer_partial *multi_xfer_find_partial(char *filename, ushort file_chksum, int stream_size, ubyte stream_flags, int force_dir)
+{
+	int idx;
+	xfer_partial *xp;
+
+	for(idx=0; idx<MAX_XFER_PARTIALS; idx++){
+		xp = &Multi_xfer_partial[idx];
+
+		if((xp->filename[0] != '\0') && !stricmp(xp->filename, filename) && (xp->file_chksum == file_chksum) && (xp->stream_size == stream_size) && 
+			(xp->stream_flags == stream_flags) && (xp->force_dir == force_dir) && (xp->received < stream_size)){
+			return xp;
+		}
+	}
+
+	return NULL;
+}
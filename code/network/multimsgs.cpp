@@ -17,6 +17,7 @@
 #include "network/multiutil.h"
 #include "network/multiui.h"
 #include "network/multi.h"
+#include "network/multi_metrics.h"
 #include "globalincs/linklist.h"
 #include "gamesequence/gamesequence.h"
 #include "hud/hudmessage.h"
@@ -449,6 +450,11 @@ void multi_io_send_force(net_player *pl)
 
 		// add the bytes sent to this player
 		pl->sv_bytes_sent += pl->s_info.unreliable_buffer_size;
+
+		if(pl->s_info.unreliable_buffer_size > 0){
+			multi_metrics_player_inc(NET_PLAYER_NUM(pl), MM_PLAYER_PACKETS_OUT);
+			multi_metrics_player_inc(NET_PLAYER_NUM(pl), MM_PLAYER_BYTES_OUT, pl->s_info.unreliable_buffer_size);
+		}
 	} else {
 		psnet_send(&Netgame.server_addr, pl->s_info.unreliable_buffer, pl->s_info.unreliable_buffer_size, NET_PLAYER_NUM(pl));		
 	}		
@@ -534,6 +540,11 @@ void multi_io_send_reliable_force(net_player *pl)
 	// send everything in 
 	if(MULTIPLAYER_MASTER) {
 		psnet_rel_send(pl->reliable_socket, pl->s_info.reliable_buffer, pl->s_info.reliable_buffer_size, NET_PLAYER_NUM(pl));
+
+		if(pl->s_info.reliable_buffer_size > 0){
+			multi_metrics_player_inc(NET_PLAYER_NUM(pl), MM_PLAYER_PACKETS_OUT);
+			multi_metrics_player_inc(NET_PLAYER_NUM(pl), MM_PLAYER_BYTES_OUT, pl->s_info.reliable_buffer_size);
+		}
 	} else if(Net_player != NULL){
 		psnet_rel_send(Net_player->reliable_socket, pl->s_info.reliable_buffer, pl->s_info.reliable_buffer_size, NET_PLAYER_NUM(pl));
 	}		
@@ -4459,6 +4459,9 @@ void multi_create_list_load_missions()
 
 	file_count = cf_get_file_list(1024, file_list, CF_TYPE_MISSIONS, wild_card);
 
+	// pick up missions changed since the last time the list was built
+	mission_header_index_rescan();
+
 	// maybe create a standalone dialog
 	if (Game_mode & GM_STANDALONE_SERVER) {
 		std_create_gen_dialog("Loading missions");
@@ -4517,6 +4520,8 @@ void multi_create_list_load_missions()
 
 	Multi_create_slider.set_numberItems(int(Multi_create_mission_list.size()) > Multi_create_list_max_display[gr_screen.res] ? int(Multi_create_mission_list.size())-Multi_create_list_max_display[gr_screen.res] : 0);
 
+	mission_header_index_save();
+
 	// maybe create a standalone dialog
 	if (Game_mode & GM_STANDALONE_SERVER) {
 		std_destroy_gen_dialog();		
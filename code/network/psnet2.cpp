@@ -42,6 +42,7 @@
 #include "io/timer.h"
 #include "network/multi_log.h"
 #include "network/multi_rate.h"
+#include "network/multi_metrics.h"
 #include "cmdline/cmdline.h"
 
 // -------------------------------------------------------------------------------------------------------
@@ -1072,6 +1073,50 @@ void psnet_flush()
 	while ( psnet_get( data, &from_addr ) > 0 ) ;
 }
 
+/**
+ * Wait up to timeout_ms for data to arrive on our socket
+ *
+ * Packets which were already read off the socket by PSNET_TOP_LAYER_PROCESS() count as data to be read
+ * so we never sleep on top of something which is waiting to be handled.
+ */
+int psnet_wait_for_data( int timeout_ms )
+{
+	network_packet_buffer_list *l;
+	fd_set	rfds;
+	timeval	timeout;
+	int		idx;
+
+	if ( Network_status != NETWORK_STATUS_RUNNING ) {
+		Sleep(timeout_ms);
+		return 0;
+	}
+
+	for (idx = 0; idx < PSNET_NUM_TYPES; idx++) {
+		l = &Psnet_top_buffers[idx];
+
+		if ( (l->psnet_lowest_id != -1) && (l->psnet_lowest_id <= l->psnet_highest_id) ) {
+			return 1;
+		}
+	}
+
+	FD_ZERO(&rfds);
+	FD_SET( Unreliable_socket, &rfds );
+	timeout.tv_sec = timeout_ms / 1000;
+	timeout.tv_usec = (timeout_ms % 1000) * 1000;
+
+#ifdef _WIN32
+	if ( select( -1, &rfds, NULL, NULL, &timeout) == SOCKET_ERROR ) {
+#else
+	if ( select( Unreliable_socket + 1, &rfds, NULL, NULL, &timeout) == SOCKET_ERROR ) {
+#endif
+		ml_printf("Error %d doing a socket select on wait", WSAGetLastError());
+		Sleep(timeout_ms);
+		return 0;
+	}
+
+	return FD_ISSET(Unreliable_socket, &rfds) ? 1 : 0;
+}
+
 /**
  * If the passed string is a valid IP string
  */
@@ -1724,6 +1769,7 @@ void psnet_rel_work()
 						rcode = SENDTO(Unreliable_socket, (char *)&send_header,RELIABLE_PACKET_HEADER_ONLY_SIZE+rsocket->send_len[i],0,&rsocket->addr,sizeof(SOCKADDR), PSNET_TYPE_RELIABLE);
 					}
 #endif
+					multi_metrics_inc(MM_COUNTER_RELIABLE_RETRANSMITS);
 
 					if((rcode == SOCKET_ERROR) && (WSAEWOULDBLOCK == WSAGetLastError())){
 						//The packet didn't get sent, flag it to try again next frame
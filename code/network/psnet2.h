@@ -165,6 +165,9 @@ int psnet_broadcast( net_addr * who_to, void * data, int len );
 // flush all sockets
 void psnet_flush();
 
+// wait up to timeout_ms for data to arrive, returns 1 if there is data to be read, 0 otherwise
+int psnet_wait_for_data( int timeout_ms );
+
 // if the passed string is a valid IP string
 int psnet_is_valid_ip_string( char *ip_string, int allow_port=1 );
 
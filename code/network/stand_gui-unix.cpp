@@ -182,6 +182,7 @@ std::string base64_decode(std::string const& encoded_string) {
 #include "network/multi_pmsg.h"
 #include "network/multi_kick.h"
 #include "network/multi_endgame.h"
+#include "network/multi_metrics.h"
 
 #include "fs2netd/fs2netd_client.h"
 
@@ -255,6 +256,58 @@ public:
     }
 };
 
+class UpdateServerCommand: public WebapiCommand {
+public:
+    UpdateServerCommand(const char *name, const char *passwd, int framecap)
+            : mHasName(name != NULL), mHasPasswd(passwd != NULL), mFramecap(framecap) {
+        if (name) {
+            mName = name;
+        }
+        if (passwd) {
+            mPasswd = passwd;
+        }
+    }
+
+    virtual void execute() {
+        if (mHasName) {
+            strcpy_s(Netgame.name, mName.c_str());
+            strcpy_s(Multi_options_g.std_pname, mName.c_str());
+            // update fs2netd with the info
+            if (MULTI_IS_TRACKER_GAME) {
+                fs2netd_gameserver_disconnect();
+                Sleep(50);
+                fs2netd_gameserver_start();
+            }
+        }
+        if (mHasPasswd) {
+            strcpy_s(Multi_options_g.std_passwd, mPasswd.c_str());
+        }
+        if (mFramecap) {
+            Multi_options_g.std_framecap = mFramecap;
+        }
+    }
+private:
+    bool mHasName;
+    bool mHasPasswd;
+    SCP_string mName;
+    SCP_string mPasswd;
+    int mFramecap;
+};
+
+class ChatCommand: public WebapiCommand {
+public:
+    ChatCommand(const char *message)
+            : mMessage(message) {
+    }
+
+    virtual void execute() {
+        send_game_chat_packet(Net_player, const_cast<char*>(mMessage.c_str()), MULTI_MSG_ALL, NULL);
+        std_add_chat_text(mMessage.c_str(), 0 /*MY_NET_PLAYER_NUM*/, 1);
+    }
+private:
+    SCP_string mMessage;
+};
+
 SDL_mutex* webapiCommandQueueMutex = SDL_CreateMutex();
 SCP_vector<WebapiCommand*> webapiCommandQueue;
 
@@ -302,6 +355,10 @@ struct LogResource {
         }
     }
 
+    bool hasEntriesAfter(long after) {
+        return !entries.empty() && entries.back().timestamp >= after;
+    }
+
     json_t* getEntriesAfter(long after) {
         json_t *msgs = json_array();
 
@@ -318,20 +375,34 @@ struct LogResource {
 };
 
 
+/**
+ * The GET resources are not built on request. Once per frame the game thread renders them
+ * into a snapshot of JSON strings and swaps it in under webapi_dataMutex, so the HTTP threads
+ * only ever copy out a string and never touch game state.
+ */
+struct SnapshotEntry {
+    SCP_string body;
+    long version;   // snapshot version in which body last changed
+};
+typedef SCP_map<SCP_string, SnapshotEntry> Snapshot;
+
 SDL_mutex *webapi_dataMutex = SDL_CreateMutex();
-netgame_info webapi_netgameInfo;
-std::map<short, net_player> webapiNetPlayers;
+SDL_cond *webapi_dataChanged = SDL_CreateCond();
+Snapshot webapiSnapshot;
+long webapiSnapshotVersion = 0;
 float webui_fps;
-float webui_missiontime;
-std::list<mission_goal> webuiMissionGoals;
 LogResource webapi_chatLog;
 LogResource webapi_debugLog;
 
+// longest a long-polling request may block one of the mongoose threads
+#define WEBAPI_LONGPOLL_MAX_WAIT 25000
+
 enum HttpStatuscode {
-    HTTP_200_OK, HTTP_401_UNAUTHORIZED, HTTP_404_NOT_FOUND, HTTP_500_INTERNAL_SERVER_ERROR
+    HTTP_200_OK, HTTP_304_NOT_MODIFIED, HTTP_401_UNAUTHORIZED, HTTP_404_NOT_FOUND, HTTP_500_INTERNAL_SERVER_ERROR
 };
 
-static void sendResponse(mg_connection *conn, std::string const& data, HttpStatuscode status) {
+static void sendResponse(mg_connection *conn, std::string const& data, HttpStatuscode status, long etag = -1,
+        const char *contentType = "application/json") {
     std::stringstream headerStream;
 
     headerStream << "HTTP/1.0 ";
@@ -339,6 +410,9 @@ static void sendResponse(mg_connection *conn, std::string const& data, HttpStatu
     case HTTP_200_OK:
         headerStream << "200 OK";
         break;
+    case HTTP_304_NOT_MODIFIED:
+        headerStream << "304 Not Modified";
+        break;
     case HTTP_401_UNAUTHORIZED:
         headerStream << "401 Unauthorized";
         break;
@@ -351,10 +425,15 @@ static void sendResponse(mg_connection *conn, std::string const& data, HttpStatu
     }
     headerStream << "\r\n";
 
+    if (etag >= 0) {
+        headerStream << "ETag: \"" << etag << "\"\r\n";
+    }
+
     if (data.length() > 0) {
         headerStream << "Content-Length: " << data.length() << "\r\n";
-        headerStream << "Content-Type: application/json\r\n\r\n";
+        headerStream << "Content-Type: " << contentType << "\r\n";
     }
+    headerStream << "\r\n";
 
     std::string resultString;
     resultString += headerStream.str();
@@ -385,99 +464,106 @@ struct Resource {
     SCP_string path;
     SCP_string method;
 
-    resourceHandler handler;
+    resourceHandler handler;    // NULL for resources served from the snapshot
 };
 
 json_t* emptyResource(ResourceContext *context) {
     return json_object();
 }
 
-json_t* serverGet(ResourceContext *context) {
-    json_t *result = json_object();
-
-    json_object_set_new(result, "name", json_string(Multi_options_g.std_pname));
-    json_object_set_new(result, "password", json_string(Multi_options_g.std_passwd));
-    json_object_set_new(result, "framecap", json_integer(Multi_options_g.std_framecap));
+/**
+ * How long the request is willing to wait for new data, from the "wait" parameter in milliseconds
+ */
+int longPollWait(ResourceContext *context) {
+    SCP_map<SCP_string, SCP_string>::iterator iter = context->parameters.find("wait");
+    if (iter != context->parameters.end()) {
+        int wait = atoi(iter->second.c_str());
+        CLAMP(wait, 0, WEBAPI_LONGPOLL_MAX_WAIT);
+        return wait;
+    }
 
-    return result;
+    return 0;
 }
 
-json_t* serverPut(ResourceContext *context) {
-    const char* name = json_string_value(json_object_get(context->requestEntity, "name"));
-    if (name) {
-        strcpy_s(Netgame.name, name);
-        strcpy_s(Multi_options_g.std_pname, name);
-        // update fs2netd with the info
-        if (MULTI_IS_TRACKER_GAME) {
-            fs2netd_gameserver_disconnect();
-            Sleep(50);
-            fs2netd_gameserver_start();
+/**
+ * Block on webapi_dataChanged until ready() or the deadline, webapi_dataMutex must be held
+ */
+template<typename Predicate>
+void longPoll(Uint32 deadline, Predicate ready) {
+    while (!ready()) {
+        Uint32 now = SDL_GetTicks();
+        if ((Sint32)(deadline - now) <= 0) {
+            break;
         }
+        SDL_CondWaitTimeout(webapi_dataChanged, webapi_dataMutex, deadline - now);
     }
-    const char* passwd = json_string_value(json_object_get(context->requestEntity, "password"));
-    if (passwd) {
-        strcpy_s(Multi_options_g.std_passwd, passwd);
-    }
-    int framecap = atoi(json_string_value(json_object_get(context->requestEntity, "framecap")));
-    if (framecap)
-    {
-        Multi_options_g.std_framecap = framecap;
-    }
-
-    return json_object();
 }
 
-json_t* serverDelete(ResourceContext *context) {
-    webapiAddCommand(new ShutdownServerCommand());
-    return json_object();
-}
+// =============================================================================
+// Snapshot builders, these run on the game thread
 
-json_t* refreshMissions(ResourceContext *context) {
-    webapiAddCommand(new UpdateMissionsCommand());
-    return json_object();
-}
+json_t* serverGet() {
+    json_t *result = json_object();
 
-json_t* serverResetGame(ResourceContext *context) {
-    webapiAddCommand(new ResetGameCommand());
-    return json_object();
-}
+    json_object_set_new(result, "name", json_string(Multi_options_g.std_pname));
+    json_object_set_new(result, "password", json_string(Multi_options_g.std_passwd));
+    json_object_set_new(result, "framecap", json_integer(Multi_options_g.std_framecap));
+    json_object_set_new(result, "idleFramecap", json_integer(Multi_options_g.std_idle_framecap));
+    json_object_set_new(result, "tickOverrun", json_string((Multi_options_g.std_tick_overrun == MULTI_TICK_OVERRUN_CATCHUP) ? "catchup" : "skip"));
 
-json_t* fs2netReset(ResourceContext *context) {
-    webapiAddCommand(new ResetFs2NetCommand());
-    return json_object();
+    return result;
 }
 
-json_t* netgameInfoGet(ResourceContext *context) {
+json_t* netgameInfoGet() {
     json_t *obj = json_object();
 
-    json_object_set_new(obj, "name", json_string(webapi_netgameInfo.name));
-    json_object_set_new(obj, "mission", json_string(webapi_netgameInfo.mission_name));
-    json_object_set_new(obj, "campaign", json_string(webapi_netgameInfo.campaign_name));
+    json_object_set_new(obj, "name", json_string(Netgame.name));
+    json_object_set_new(obj, "mission", json_string(Netgame.mission_name));
+    json_object_set_new(obj, "campaign", json_string(Netgame.campaign_name));
 
-    json_object_set_new(obj, "maxPlayers", json_integer(webapi_netgameInfo.max_players));
-    json_object_set_new(obj, "maxObservers", json_integer(webapi_netgameInfo.options.max_observers));
-    json_object_set_new(obj, "respawn", json_integer(webapi_netgameInfo.respawn));
+    json_object_set_new(obj, "maxPlayers", json_integer(Netgame.max_players));
+    json_object_set_new(obj, "maxObservers", json_integer(Netgame.options.max_observers));
+    json_object_set_new(obj, "respawn", json_integer(Netgame.respawn));
 
-    json_object_set_new(obj, "gameState", json_integer(webapi_netgameInfo.game_state));
+    json_object_set_new(obj, "gameState", json_integer(Netgame.game_state));
 
-    json_object_set_new(obj, "security", json_integer(webapi_netgameInfo.security));
+    json_object_set_new(obj, "security", json_integer(Netgame.security));
     return obj;
 }
 
-json_t* missionGet(ResourceContext *context) {
+json_t* missionGet() {
     json_t *fpsEntity = json_object();
 
     json_object_set_new(fpsEntity, "fps", json_real(webui_fps));
-    json_object_set_new(fpsEntity, "time", json_real(webui_missiontime));
+    json_object_set_new(fpsEntity, "time", json_real(f2fl(Missiontime)));
 
     return fpsEntity;
 }
 
-json_t* missionGoalsGet(ResourceContext *context) {
+json_t* serverTickGet() {
+    multi_tick_stats webapi_tickStats;
+    multi_tick_get_stats(&webapi_tickStats);
+
+    json_t *obj = json_object();
+
+    json_object_set_new(obj, "rate", json_real(webapi_tickStats.rate));
+    json_object_set_new(obj, "ticks", json_integer(webapi_tickStats.ticks));
+    json_object_set_new(obj, "overruns", json_integer(webapi_tickStats.overruns));
+    json_object_set_new(obj, "skipped", json_integer(webapi_tickStats.skipped));
+    json_object_set_new(obj, "earlyWakes", json_integer(webapi_tickStats.early_wakes));
+    json_object_set_new(obj, "lastWork", json_real(webapi_tickStats.last_work));
+    json_object_set_new(obj, "lastWait", json_real(webapi_tickStats.last_wait));
+    json_object_set_new(obj, "avgWork", json_real(webapi_tickStats.avg_work));
+    json_object_set_new(obj, "maxWork", json_real(webapi_tickStats.max_work));
+
+    return obj;
+}
+
+json_t* missionGoalsGet() {
     json_t *goals = json_array();
 
-    for (std::list<mission_goal>::iterator iter = webuiMissionGoals.begin(); iter != webuiMissionGoals.end(); ++iter) {
-        mission_goal goal = *iter;
+    for (int idx = 0; idx < Num_goals; idx++) {
+        mission_goal &goal = Mission_goals[idx];
 
         json_t *goalEntity = json_object();
 
@@ -526,12 +612,14 @@ json_t* missionGoalsGet(ResourceContext *context) {
     return goals;
 }
 
-json_t* playerGet(ResourceContext *context) {
+json_t* playerGet() {
     json_t *playerList = json_array();
 
-    for (std::map<short, net_player>::iterator iter = webapiNetPlayers.begin(); iter != webapiNetPlayers.end();
-            ++iter) {
-        net_player p = iter->second;
+    for (size_t idx = 0; idx < MAX_PLAYERS; idx++) {
+        if (!MULTI_CONNECTED(Net_players[idx]) || (Net_player == &Net_players[idx])) {
+            continue;
+        }
+        net_player &p = Net_players[idx];
 
         char address[256];
         sprintf(address, "%u.%u.%u.%u:%u", p.p_info.addr.addr[0], p.p_info.addr.addr[1], p.p_info.addr.addr[2],
@@ -539,41 +627,21 @@ json_t* playerGet(ResourceContext *context) {
 
         json_t *obj = json_object();
 
-        json_object_set(obj, "id", json_integer(p.player_id));
-        json_object_set(obj, "address", json_string(address));
-        json_object_set(obj, "ping", json_integer(p.s_info.ping.ping_avg));
-        json_object_set(obj, "host", (MULTI_HOST(p)) ? json_true() : json_false());
-        json_object_set(obj, "observer", (MULTI_OBSERVER(p)) ? json_true() : json_false());
-        json_object_set(obj, "callsign", json_string(p.m_player->callsign));
-        json_object_set(obj, "ship", json_string(Ship_info[p.p_info.ship_class].name));
+        json_object_set_new(obj, "id", json_integer(p.player_id));
+        json_object_set_new(obj, "address", json_string(address));
+        json_object_set_new(obj, "ping", json_integer(p.s_info.ping.ping_avg));
+        json_object_set_new(obj, "host", (MULTI_HOST(p)) ? json_true() : json_false());
+        json_object_set_new(obj, "observer", (MULTI_OBSERVER(p)) ? json_true() : json_false());
+        json_object_set_new(obj, "callsign", json_string(p.m_player->callsign));
+        json_object_set_new(obj, "ship", json_string(Ship_info[p.p_info.ship_class].name));
 
-        json_array_append(playerList, obj);
+        json_array_append_new(playerList, obj);
     }
 
     return playerList;
 }
 
-json_t* playerDelete(ResourceContext *context) {
-    int playerId = atoi(context->parameters["playerId"].c_str());
-    webapiAddCommand(new KickPlayerCommand(playerId));
-    return json_object();
-}
-
-net_player *playerForId(int playerId) {
-    net_player *foundPlayer = NULL;
-    for (size_t idx = 0; idx < MAX_PLAYERS; idx++) {
-        if (MULTI_CONNECTED(Net_players[idx])) {
-            if (Net_players[idx].player_id == playerId) {
-                foundPlayer = &Net_players[idx];
-            }
-        }
-    }
-    return foundPlayer;
-}
-
-json_t* playerMissionScoreAlltimeGet(ResourceContext *context) {
-    net_player *p = playerForId(atoi(context->parameters["playerId"].c_str()));
-
+json_t* playerMissionScoreAlltimeGet(net_player *p) {
     json_t *obj2 = json_object();
     if (p == NULL || p->m_player == NULL)
         return obj2;
@@ -595,9 +663,7 @@ json_t* playerMissionScoreAlltimeGet(ResourceContext *context) {
     return obj2;
 }
 
-json_t* playerMissionScoreMissionGet(ResourceContext *context) {
-    net_player *p = playerForId(atoi(context->parameters["playerId"].c_str()));
-
+json_t* playerMissionScoreMissionGet(net_player *p) {
     json_t *obj = json_object();
     if (p == NULL || p->m_player == NULL)
         return obj;
@@ -619,6 +685,142 @@ json_t* playerMissionScoreMissionGet(ResourceContext *context) {
     return obj;
 }
 
+/**
+ * Render one resource into the snapshot being built. The version is carried over from the
+ * published snapshot if the body didn't change, so long-polling clients only wake up on changes.
+ */
+static void snapshotSet(Snapshot &snapshot, SCP_string const& path, json_t *entity) {
+    char *dumped = json_dumps(entity, 0);
+    json_delete(entity);
+
+    SnapshotEntry &entry = snapshot[path];
+    entry.body = dumped ? dumped : "";
+    free(dumped);
+
+    Snapshot::const_iterator published = webapiSnapshot.find(path);
+    if (published != webapiSnapshot.end() && published->second.body == entry.body) {
+        entry.version = published->second.version;
+    } else {
+        entry.version = webapiSnapshotVersion + 1;
+    }
+}
+
+static void webapiPublishSnapshot() {
+    Snapshot snapshot;
+
+    snapshotSet(snapshot, "api/1/server", serverGet());
+    snapshotSet(snapshot, "api/1/server/tick", serverTickGet());
+    snapshotSet(snapshot, "api/1/netgameInfo", netgameInfoGet());
+    snapshotSet(snapshot, "api/1/mission", missionGet());
+    snapshotSet(snapshot, "api/1/mission/goals", missionGoalsGet());
+    snapshotSet(snapshot, "api/1/player", playerGet());
+
+    for (size_t idx = 0; idx < MAX_PLAYERS; idx++) {
+        if (MULTI_CONNECTED(Net_players[idx])) {
+            char path[64];
+            sprintf(path, "api/1/player/%d/score/", Net_players[idx].player_id);
+
+            snapshotSet(snapshot, SCP_string(path) + "mission", playerMissionScoreMissionGet(&Net_players[idx]));
+            snapshotSet(snapshot, SCP_string(path) + "alltime", playerMissionScoreAlltimeGet(&Net_players[idx]));
+        }
+    }
+
+    SDL_mutexP(webapi_dataMutex);
+    webapiSnapshot.swap(snapshot);
+    webapiSnapshotVersion++;
+    SDL_CondBroadcast(webapi_dataChanged);
+    SDL_mutexV(webapi_dataMutex);
+
+    // the old snapshot is freed here, outside the lock
+}
+
+/**
+ * Serve a GET resource from the published snapshot. A request with If-None-Match set to the
+ * current ETag and a "wait" parameter is held until the resource changes or the wait runs out.
+ */
+struct SnapshotChanged {
+    SCP_string const& path;
+    long known;
+
+    SnapshotChanged(SCP_string const& p, long k)
+            : path(p), known(k) {
+    }
+
+    bool operator()() const {
+        Snapshot::const_iterator iter = webapiSnapshot.find(path);
+        return ((iter != webapiSnapshot.end()) ? iter->second.version : 0) != known;
+    }
+};
+
+static void sendSnapshotResponse(mg_connection *conn, SCP_string const& path, ResourceContext *context) {
+    long known = -1;
+    const char *ifNoneMatch = mg_get_header(conn, "If-None-Match");
+    if (ifNoneMatch) {
+        known = atol(ifNoneMatch + ((ifNoneMatch[0] == '"') ? 1 : 0));
+    }
+
+    SCP_string body;
+    long version = 0;
+
+    SDL_mutexP(webapi_dataMutex);
+
+    longPoll(SDL_GetTicks() + longPollWait(context), SnapshotChanged(path, known));
+
+    Snapshot::const_iterator iter = webapiSnapshot.find(path);
+    if (iter != webapiSnapshot.end()) {
+        body = iter->second.body;
+        version = iter->second.version;
+    }
+
+    SDL_mutexV(webapi_dataMutex);
+
+    if (version == known) {
+        sendResponse(conn, std::string(), HTTP_304_NOT_MODIFIED, version);
+    } else {
+        // unknown players get an empty object, like before
+        sendResponse(conn, body.empty() ? std::string("{}") : std::string(body.c_str()), HTTP_200_OK, version);
+    }
+}
+
+// =============================================================================
+// Request handlers, these run on the mongoose threads with webapi_dataMutex held
+
+json_t* serverPut(ResourceContext *context) {
+    const char* name = json_string_value(json_object_get(context->requestEntity, "name"));
+    const char* passwd = json_string_value(json_object_get(context->requestEntity, "password"));
+    const char* framecap = json_string_value(json_object_get(context->requestEntity, "framecap"));
+
+    webapiAddCommand(new UpdateServerCommand(name, passwd, framecap ? atoi(framecap) : 0));
+
+    return json_object();
+}
+
+json_t* serverDelete(ResourceContext *context) {
+    webapiAddCommand(new ShutdownServerCommand());
+    return json_object();
+}
+
+json_t* refreshMissions(ResourceContext *context) {
+    webapiAddCommand(new UpdateMissionsCommand());
+    return json_object();
+}
+
+json_t* serverResetGame(ResourceContext *context) {
+    webapiAddCommand(new ResetGameCommand());
+    return json_object();
+}
+
+json_t* fs2netReset(ResourceContext *context) {
+    webapiAddCommand(new ResetFs2NetCommand());
+    return json_object();
+}
+
+json_t* playerDelete(ResourceContext *context) {
+    int playerId = atoi(context->parameters["playerId"].c_str());
+    webapiAddCommand(new KickPlayerCommand(playerId));
+    return json_object();
+}
+
 int afterTimestamp(ResourceContext *context) {
     SCP_map<SCP_string, SCP_string>::iterator iter = context->parameters.find("after");
     if (iter != context->parameters.end()) {
@@ -628,16 +830,32 @@ int afterTimestamp(ResourceContext *context) {
     return 0;
 }
 
+struct LogHasEntriesAfter {
+    LogResource &log;
+    long after;
+
+    LogHasEntriesAfter(LogResource &l, long a)
+            : log(l), after(a) {
+    }
+
+    bool operator()() const {
+        return log.hasEntriesAfter(after);
+    }
+};
+
+/**
+ * With a "wait" parameter these long-poll: the request is held until there is a newer entry
+ */
 json_t* chatGet(ResourceContext *context) {
     int after = afterTimestamp(context);
+    longPoll(SDL_GetTicks() + longPollWait(context), LogHasEntriesAfter(webapi_chatLog, after));
     return webapi_chatLog.getEntriesAfter(after);
 }
 
 json_t* chatPost(ResourceContext *context) {
     const char* message = json_string_value(json_object_get(context->requestEntity, "message"));
     if (message) {
-        send_game_chat_packet(Net_player, const_cast<char*>(message), MULTI_MSG_ALL, NULL);
-        std_add_chat_text(const_cast<char*>(message), 0 /*MY_NET_PLAYER_NUM*/, 1);
+        webapiAddCommand(new ChatCommand(message));
     }
     
     return emptyResource(context);
@@ -645,28 +863,56 @@ json_t* chatPost(ResourceContext *context) {
 
 json_t* debugGet(ResourceContext *context) {
     int after = afterTimestamp(context);
+    longPoll(SDL_GetTicks() + longPollWait(context), LogHasEntriesAfter(webapi_debugLog, after));
     return webapi_debugLog.getEntriesAfter(after);
 }
 
 struct Resource resources[] = {
     { "api/1/auth", "GET", &emptyResource },
-    { "api/1/server", "GET", &serverGet },
+    { "api/1/server", "GET", NULL },
     { "api/1/server", "PUT", &serverPut },
     { "api/1/server", "DELETE", &serverDelete },
     { "api/1/server/refreshMissions", "GET", &refreshMissions },
     { "api/1/server/resetGame", "GET", &serverResetGame },
     { "api/1/server/fs2net/reset", "GET", &fs2netReset },
-    { "api/1/netgameInfo", "GET", &netgameInfoGet },
-    { "api/1/mission", "GET", &missionGet },
-    { "api/1/mission/goals", "GET", &missionGoalsGet },
-    { "api/1/player", "GET", &playerGet },
+    { "api/1/server/tick", "GET", NULL },
+    { "api/1/netgameInfo", "GET", NULL },
+    { "api/1/mission", "GET", NULL },
+    { "api/1/mission/goals", "GET", NULL },
+    { "api/1/player", "GET", NULL },
     { "api/1/player/*", "DELETE", &playerDelete },
-    { "api/1/player/*/score/mission", "GET", &playerMissionScoreMissionGet },
-    { "api/1/player/*/score/alltime", "GET", &playerMissionScoreAlltimeGet },
+    { "api/1/player/*/score/mission", "GET", NULL },
+    { "api/1/player/*/score/alltime", "GET", NULL },
     { "api/1/chat", "GET", &chatGet },
     { "api/1/chat", "POST", &chatPost },
     { "api/1/debug", "GET", &debugGet } };
 
+static bool webapiAuthorized(mg_connection *conn) {
+    std::string userNameAndPassword;
+
+    userNameAndPassword += Multi_options_g.webapiUsername.c_str();
+    userNameAndPassword += ":";
+    userNameAndPassword += Multi_options_g.webapiPassword.c_str();
+
+    std::string basicAuthValue = "Basic ";
+
+    basicAuthValue += base64_encode(reinterpret_cast<const unsigned char*>(userNameAndPassword.c_str()), userNameAndPassword.length());
+
+    const char* authValue = mg_get_header(conn, "Authorization");
+    return authValue != NULL && strcmp(authValue, basicAuthValue.c_str()) == 0;
+}
+
+/**
+ * Prometheus scrape endpoint. The counters are summed straight out of the per-thread blocks,
+ * so this doesn't need webapi_dataMutex or the snapshot.
+ */
+static void sendMetricsResponse(mg_connection *conn) {
+    SCP_string metrics;
+    multi_metrics_render(metrics);
+
+    sendResponse(conn, std::string(metrics.c_str()), HTTP_200_OK, -1, "text/plain; version=0.0.4");
+}
+
 static bool webserverApiRequest(mg_connection *conn, const mg_request_info *ri) {
     SCP_string resourcePath(ri->uri);
 
@@ -674,6 +920,15 @@ static bool webserverApiRequest(mg_connection *conn, const mg_request_info *ri)
     SCP_vector<SCP_string> pathParts;
     split(pathParts, resourcePath, "/", split_struct::no_empties);
 
+    if (pathParts.size() == 1 && pathParts[0] == "metrics" && !strcmp(ri->request_method, "GET")) {
+        if (!webapiAuthorized(conn)) {
+            sendResponse(conn, std::string(), HTTP_401_UNAUTHORIZED);
+        } else {
+            sendMetricsResponse(conn);
+        }
+        return true;
+    }
+
     json_t *result = NULL;
 
     SCP_string method(ri->request_method);
@@ -699,18 +954,7 @@ static bool webserverApiRequest(mg_connection *conn, const mg_request_info *ri)
 
             if (pathMatch && r->method == method) {
 
-                std::string userNameAndPassword;
-                
-                userNameAndPassword += Multi_options_g.webapiUsername.c_str();
-                userNameAndPassword += ":";
-                userNameAndPassword += Multi_options_g.webapiPassword.c_str();
-                
-                std::string basicAuthValue = "Basic ";
-                
-                basicAuthValue += base64_encode(reinterpret_cast<const unsigned char*>(userNameAndPassword.c_str()), userNameAndPassword.length());
-
-                const char* authValue = mg_get_header(conn, "Authorization");
-                if (authValue == NULL || strcmp(authValue, basicAuthValue.c_str()) != 0) {
+                if (!webapiAuthorized(conn)) {
                     sendResponse(conn, std::string(), HTTP_401_UNAUTHORIZED);
                     return true;
                 }
@@ -732,8 +976,22 @@ static bool webserverApiRequest(mg_connection *conn, const mg_request_info *ri)
                     }
                 }
 
+                if (r->handler == NULL) {
+                    SCP_string snapshotPath;
+                    for (size_t u = 0; u < pathParts.size(); u++) {
+                        if (u > 0) {
+                            snapshotPath += "/";
+                        }
+                        snapshotPath += pathParts.at(u);
+                    }
+
+                    sendSnapshotResponse(conn, snapshotPath, &context);
+                    return true;
+                }
+
                 char entityBuffer[1024];
-                /*int readBytes = */mg_read(conn, &entityBuffer, sizeof(entityBuffer));
+                memset(entityBuffer, 0, sizeof(entityBuffer));
+                /*int readBytes = */mg_read(conn, &entityBuffer, sizeof(entityBuffer) - 1);
 
                 json_error_t parseError;
                 context.requestEntity = json_loads((const char*) &entityBuffer, JSON_DISABLE_EOF_CHECK, &parseError);
@@ -743,6 +1001,8 @@ static bool webserverApiRequest(mg_connection *conn, const mg_request_info *ri)
                 result = r->handler(&context);
                 SDL_mutexV(webapi_dataMutex);
 
+                json_decref(context.requestEntity);
+
                 break;
             }
         }
@@ -795,10 +1055,11 @@ void std_configLoaded(multi_global_options *options) {
     char buffer[16];
     sprintf(buffer, "%d", options->webapiPort);
 
+    // long-polling requests each hold a thread, so leave some for everything else
     const char *mgOptions[] = {
         "listening_ports", buffer,
         "document_root", options->webuiRootDirectory.c_str(),
-        "num_threads", "4",
+        "num_threads", "8",
         NULL };
 
     mprintf(("Webapi starting on port: %d with document root at: %s\n", options->webapiPort, options->webuiRootDirectory.c_str()));
@@ -812,7 +1073,10 @@ void std_add_chat_text(const char *text, int player_index, int add_id) {
     //json_object_set_new(msg, "source",    json_string(Net_players[player_index].m_player->callsign));
     json_object_set_new(msg, "message", json_string(text));
 
+    SDL_mutexP(webapi_dataMutex);
     webapi_chatLog.addEntity(msg);
+    SDL_CondBroadcast(webapi_dataChanged);
+    SDL_mutexV(webapi_dataMutex);
 }
 
 void std_debug_multilog_add_line(const char *str) {
@@ -820,11 +1084,14 @@ void std_debug_multilog_add_line(const char *str) {
     SCP_vector<SCP_string> debugMessages;
     split(debugMessages, SCP_string(str), "\n", split_struct::no_empties);
 
+    SDL_mutexP(webapi_dataMutex);
     for (SCP_vector<SCP_string>::const_iterator iter = debugMessages.begin(); iter != debugMessages.end(); ++iter) {
         json_t *msg = json_object();
         json_object_set_new(msg, "message", json_string(str));
         webapi_debugLog.addEntity(msg);
     }
+    SDL_CondBroadcast(webapi_dataChanged);
+    SDL_mutexV(webapi_dataMutex);
 }
 
 // =============================================================================
@@ -851,32 +1118,11 @@ void std_set_standalone_fps(float fps) {
 }
 
 void std_do_gui_frame() {
-    SDL_mutexP(webapi_dataMutex);
-
-    webapi_netgameInfo = Netgame;
-
-    // Update player data
-    webapiNetPlayers.clear();
-
-    for (size_t idx = 0; idx < MAX_PLAYERS; idx++) {
-        if (MULTI_CONNECTED(Net_players[idx]) && (Net_player != &Net_players[idx])) {
-            net_player* p = &Net_players[idx];
-
-            webapiNetPlayers[p->player_id] = *p;
-        }
-    }
-
-    // Update mission data
-    webui_missiontime = f2fl(Missiontime);
-
-    webuiMissionGoals.clear();
-    for (int idx = 0; idx < Num_goals; idx++) {
-        webuiMissionGoals.push_back(Mission_goals[idx]);
-    }
-
-    SDL_mutexV(webapi_dataMutex);
+    multi_metrics_frame();
 
     webapiExecuteCommands();
+
+    webapiPublishSnapshot();
 }
 
 // set the game name for the standalone. passing NULL uses the default
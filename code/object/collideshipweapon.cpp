@@ -21,6 +21,7 @@
 #include "network/multi.h"
 #include "network/multiutil.h"
 #include "network/multimsgs.h"
+#include "network/multi_obj.h"
 #include "parse/lua.h"
 #include "parse/scripting.h"
 #include "ship/shipfx.h"
@@ -161,6 +162,11 @@ int ship_weapon_check_collision(object *ship_objp, object *weapon_objp, float ti
 	vm_vec_scale_add( &weapon_end_pos, &weapon_objp->pos, &weapon_objp->phys_info.vel, time_limit );
 
 
+	// in multiplayer, check client fired weapons against where the client saw the ship
+	vec3d ship_pos = ship_objp->pos;
+	matrix ship_orient = ship_objp->orient;
+	int rewound = multi_oo_lag_comp_rewind(ship_objp, weapon_objp, &ship_pos, &ship_orient);
+
 	// Goober5000 - I tried to make collision code here much saner... here begin the (major) changes
 	mc_info_init(&mc);
 
@@ -168,8 +174,8 @@ int ship_weapon_check_collision(object *ship_objp, object *weapon_objp, float ti
 	mc.model_instance_num = shipp->model_instance_num;
 	mc.model_num = sip->model_num;
 	mc.submodel_num = -1;
-	mc.orient = &ship_objp->orient;
-	mc.pos = &ship_objp->pos;
+	mc.orient = &ship_orient;
+	mc.pos = &ship_pos;
 	mc.p0 = &weapon_objp->last_pos;
 	mc.p1 = &weapon_end_pos;
 	memcpy(&mc_shield, &mc, sizeof(mc_info));
@@ -290,8 +296,8 @@ int ship_weapon_check_collision(object *ship_objp, object *weapon_objp, float ti
 				// Re-calculate hit_point because it's likely pointing to the wrong
 				// place
 				vec3d tempv;
-				vm_vec_sub(&tempv, &mc_shield.hit_point_world, &ship_objp->pos);
-				vm_vec_rotate(&mc_shield.hit_point, &tempv, &ship_objp->orient);
+				vm_vec_sub(&tempv, &mc_shield.hit_point_world, &ship_pos);
+				vm_vec_rotate(&mc_shield.hit_point, &tempv, &ship_orient);
 			}
 		} else if (sip->flags2 & SIF2_SURFACE_SHIELDS) {
 			mc_shield.flags = MC_CHECK_MODEL;
@@ -301,8 +307,8 @@ int ship_weapon_check_collision(object *ship_objp, object *weapon_objp, float ti
 			// in a submodel's frame of reference, so we need to ensure we end up
 			// in the ship's frame of reference
 			vec3d local_pos;
-			vm_vec_sub(&local_pos, &mc_shield.hit_point_world, &ship_objp->pos);
-			vm_vec_rotate(&mc_shield.hit_point, &local_pos, &ship_objp->orient);
+			vm_vec_sub(&local_pos, &mc_shield.hit_point_world, &ship_pos);
+			vm_vec_rotate(&mc_shield.hit_point, &local_pos, &ship_orient);
 		} else {
 			// Normal collision check against a shield mesh
 			mc_shield.flags = MC_CHECK_SHIELD;
@@ -362,6 +368,11 @@ int ship_weapon_check_collision(object *ship_objp, object *weapon_objp, float ti
 		valid_hit_occurred = 1;
 	}
 
+	// the hit was found against where the ship used to be, so put the impact on the ship where it is now
+	if (rewound && valid_hit_occurred) {
+		multi_oo_lag_comp_restore(ship_objp, &ship_pos, &ship_orient, &mc.hit_point_world);
+	}
+
     // check if the hit point is beyond the clip plane when warping out.
     if ((shipp->flags & SF_DEPART_WARP) &&
         (shipp->warpout_effect) &&
@@ -661,6 +672,11 @@ collision_result ship_weapon_check_collision_safe(obj_pair * pair, collision_exe
 	vm_vec_scale_add( &weapon_end_pos, &pair->b->pos, &pair->b->phys_info.vel, time_limit );
 
 
+	// in multiplayer, check client fired weapons against where the client saw the ship
+	vec3d ship_pos = pair->a->pos;
+	matrix ship_orient = pair->a->orient;
+	int rewound = multi_oo_lag_comp_rewind(pair->a, pair->b, &ship_pos, &ship_orient);
+
 	// Goober5000 - I tried to make collision code here much saner... here begin the (major) changes
 	mc = &(data->ship_weapon.mc);
 	mc_info_init(mc);
@@ -669,8 +685,8 @@ collision_result ship_weapon_check_collision_safe(obj_pair * pair, collision_exe
 	mc->model_instance_num = shipp->model_instance_num;
 	mc->model_num = sip->model_num;
 	mc->submodel_num = -1;
-	mc->orient = &pair->a->orient;
-	mc->pos = &pair->a->pos;
+	mc->orient = &ship_orient;
+	mc->pos = &ship_pos;
 	mc->p0 = &pair->b->last_pos;
 	mc->p1 = &weapon_end_pos;
 	memcpy(&mc_shield, mc, sizeof(mc_info));
@@ -791,8 +807,8 @@ collision_result ship_weapon_check_collision_safe(obj_pair * pair, collision_exe
 				// Re-calculate hit_point because it's likely pointing to the wrong
 				// place
 				vec3d tempv;
-				vm_vec_sub(&tempv, &mc_shield.hit_point_world, &pair->a->pos);
-				vm_vec_rotate(&mc_shield.hit_point, &tempv, &pair->a->orient);
+				vm_vec_sub(&tempv, &mc_shield.hit_point_world, &ship_pos);
+				vm_vec_rotate(&mc_shield.hit_point, &tempv, &ship_orient);
 			}
 		} else if (sip->flags2 & SIF2_SURFACE_SHIELDS) {
 			mc_shield.flags = MC_CHECK_MODEL;
@@ -802,8 +818,8 @@ collision_result ship_weapon_check_collision_safe(obj_pair * pair, collision_exe
 			// in a submodel's frame of reference, so we need to ensure we end up
 			// in the ship's frame of reference
 			vec3d local_pos;
-			vm_vec_sub(&local_pos, &mc_shield.hit_point_world, &pair->a->pos);
-			vm_vec_rotate(&mc_shield.hit_point, &local_pos, &pair->a->orient);
+			vm_vec_sub(&local_pos, &mc_shield.hit_point_world, &ship_pos);
+			vm_vec_rotate(&mc_shield.hit_point, &local_pos, &ship_orient);
 		} else {
 			// Normal collision check against a shield mesh
 			mc_shield.flags = MC_CHECK_SHIELD;
@@ -863,6 +879,11 @@ collision_result ship_weapon_check_collision_safe(obj_pair * pair, collision_exe
 		valid_hit_occurred = 1;
 	}
 
+	// the hit was found against where the ship used to be, so put the impact on the ship where it is now
+	if (rewound && valid_hit_occurred) {
+		multi_oo_lag_comp_restore(pair->a, &ship_pos, &ship_orient, &mc->hit_point_world);
+	}
+
     // check if the hit point is beyond the clip plane when warping out.
     if ((shipp->flags & SF_DEPART_WARP) &&
         (shipp->warpout_effect) &&
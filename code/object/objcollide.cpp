@@ -17,6 +17,7 @@
 #include "weapon/weapon.h"
 #include "object/objectdock.h"
 #include "multithread/multithread.h"
+#include "network/multi_metrics.h"
 
 
 
@@ -43,6 +44,10 @@ obj_pair pair_free_list;
 
 SCP_vector<int> Collision_sort_list;
 
+// beams span far too much of the mission to sweep and prune usefully, so they are kept here instead
+// and swept against the sorted colliders on their own; see obj_collide_beams()
+SCP_vector<int> Collision_beam_list;
+
 SCP_hash_map<uint, collider_pair> Collision_cached_pairs;
 
 struct checkobject;
@@ -1164,7 +1169,10 @@ void obj_add_collider(int obj_index)
 		return;
 	}
 
-	Collision_sort_list.push_back(obj_index);
+	if (objp->type == OBJ_BEAM)
+		Collision_beam_list.push_back(obj_index);
+	else
+		Collision_sort_list.push_back(obj_index);
 
 	objp->flags &= ~OF_NOT_IN_COLL;	
 }
@@ -1176,11 +1184,12 @@ void obj_remove_collider(int obj_index)
 #endif	
 
 	size_t i;
+	SCP_vector<int> *list = (Objects[obj_index].type == OBJ_BEAM) ? &Collision_beam_list : &Collision_sort_list;
 
-	for ( i = 0; i < Collision_sort_list.size(); ++i ) {
-		if ( Collision_sort_list[i] == obj_index ) {
-			Collision_sort_list[i] = Collision_sort_list.back();
-			Collision_sort_list.pop_back();
+	for ( i = 0; i < list->size(); ++i ) {
+		if ( (*list)[i] == obj_index ) {
+			(*list)[i] = list->back();
+			list->pop_back();
 			break;
 		}
 	}
@@ -1191,6 +1200,7 @@ void obj_remove_collider(int obj_index)
 void obj_reset_colliders()
 {
 	Collision_sort_list.clear();
+	Collision_beam_list.clear();
 	if (Cmdline_num_threads > 1) {
 //		collision_cache.clear();
 	}
@@ -1228,6 +1238,7 @@ void collision_quicksort_multithread(SCP_vector<int> *collision_sort_list, int a
 	vars.left = 0;
 	vars.right = (*vars.list).size() - 1;
 	vars.axis = axis;
+	vars.job = NULL;
 	if (SDL_LockMutex(quicksort_queue_mutex) < 0) {
 		Error(LOCATION, "quicksort_queue_mutex lock failed: %s\n", SDL_GetError());
 	}
@@ -1312,6 +1323,128 @@ void obj_sort_and_collide()
 	obj_quicksort_colliders(&sort_list_z, 0, sort_list_z.size() - 1, 2);
 	obj_find_overlap_colliders(&sort_list_y, &sort_list_z, 2, true);
 #endif
+
+	obj_collide_beams();
+}
+
+// squared distance from p to the closest point on the segment p0-p1
+static float obj_point_segment_dist_squared(vec3d *p, vec3d *p0, vec3d *p1)
+{
+	vec3d seg, rel, closest;
+	float len_squared, t;
+
+	vm_vec_sub(&seg, p1, p0);
+	vm_vec_sub(&rel, p, p0);
+
+	len_squared = vm_vec_mag_squared(&seg);
+	t = (len_squared > 0.0f) ? (vm_vec_dotprod(&rel, &seg) / len_squared) : 0.0f;
+	CLAMP(t, 0.0f, 1.0f);
+
+	vm_vec_scale_add(&closest, p0, &seg, t);
+
+	return vm_vec_dist_squared(p, &closest);
+}
+
+void obj_collide_beams()
+{
+	size_t i, j, first, count;
+	float max_extent = 0.0f;
+
+	if (Collision_beam_list.empty())
+		return;
+
+	// The sweep above leaves Collision_sort_list sorted by its minimum x endpoint.  Nothing in it is
+	// wider than max_extent, so the colliders that can reach a beam's x range form a single window.
+	for (i = 0; i < Collision_sort_list.size(); ++i) {
+		float extent = obj_get_collider_endpoint(Collision_sort_list[i], 0, false) - obj_get_collider_endpoint(Collision_sort_list[i], 0, true);
+		max_extent = MAX(max_extent, extent);
+	}
+
+	// with more than one thread the model checks are farmed out to the collider threads and the hits
+	// are applied here afterwards, in the order the pairs were found
+	bool threaded = (Cmdline_num_threads > 1);
+
+#ifndef MULTITHREADING_NARROWPHASE_COLLISIONS
+	if (threaded) {
+		collision_pair_clear();
+	}
+#endif
+
+	for (i = 0; i < Collision_beam_list.size(); ++i) {
+		object *beam_objp = &Objects[Collision_beam_list[i]];
+		beam *b = &Beams[beam_objp->instance];
+
+		// warming up, warming down or on safety, so the pair functions would throw everything out anyway
+		if ((b->warmup_stamp != -1) || (b->warmdown_stamp != -1) || (b->flags & BF_SAFETY))
+			continue;
+
+		float half_width = MAX(beam_get_widest(b), 0.0f) * 0.5f;
+		float x_min = MIN(b->last_start.xyz.x, b->last_shot.xyz.x) - half_width;
+		float x_max = MAX(b->last_start.xyz.x, b->last_shot.xyz.x) + half_width;
+
+		// binary search for the first collider whose maximum could reach x_min
+		first = 0;
+		count = Collision_sort_list.size();
+		while (count > 0) {
+			size_t step = count / 2;
+
+			if (obj_get_collider_endpoint(Collision_sort_list[first + step], 0, true) < (x_min - max_extent)) {
+				first += step + 1;
+				count -= step + 1;
+			} else {
+				count = step;
+			}
+		}
+
+		for (j = first; j < Collision_sort_list.size(); ++j) {
+			int objnum = Collision_sort_list[j];
+
+			if (obj_get_collider_endpoint(objnum, 0, true) > x_max)
+				break;
+
+			if (obj_get_collider_endpoint(objnum, 0, false) < x_min)
+				continue;
+
+			object *objp = &Objects[objnum];
+
+			switch (objp->type) {
+				case OBJ_SHIP:
+				case OBJ_ASTEROID:
+				case OBJ_DEBRIS:
+				case OBJ_WEAPON:
+					break;
+
+				default:
+					continue;
+			}
+
+			// is the bounding sphere anywhere near the beam?  weapons get their whole move this frame
+			float reach = objp->radius + half_width;
+			if (objp->type == OBJ_WEAPON)
+				reach += vm_vec_dist(&objp->pos, &objp->last_pos);
+
+			if (obj_point_segment_dist_squared(&objp->pos, &b->last_start, &b->last_shot) > (reach * reach))
+				continue;
+
+			if (threaded) {
+				// the collider threads may only read the ship's submodel transforms, so bring them up to date here
+				if (objp->type == OBJ_SHIP)
+					model_instance_update_transforms(Ships[objp->instance].model_instance_num);
+
+				collision_pair_add(beam_objp, objp);
+			} else {
+				obj_collide_pair(beam_objp, objp);
+			}
+		}
+	}
+
+	// with MULTITHREADING_NARROWPHASE_COLLISIONS these are evaluated along with every other pair in obj_check_all_collisions()
+#ifndef MULTITHREADING_NARROWPHASE_COLLISIONS
+	if (threaded) {
+		evaluate_collisions();
+		execute_collisions();
+	}
+#endif
 }
 
 void obj_find_overlap_colliders(SCP_vector<int> *overlap_list_out, SCP_vector<int> *list, int axis, bool collide)
@@ -1423,6 +1556,8 @@ void obj_collide_pair(object *A, object *B)
 
 	if ( A==B ) return;		// Don't check collisions with yourself
 
+	multi_metrics_inc(MM_COUNTER_COLLISION_PAIRS);
+
 	if ( !(A->flags&OF_COLLIDES) ) return;		// This object doesn't collide with anything
 	if ( !(B->flags&OF_COLLIDES) ) return;		// This object doesn't collide with anything
 	
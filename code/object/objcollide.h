@@ -54,6 +54,7 @@ void obj_reset_colliders();
 
 void obj_check_all_collisions();
 void obj_sort_and_collide();
+void obj_collide_beams();
 void obj_quicksort_colliders(SCP_vector<int> *list, int left, int right, int axis);
 void obj_find_overlap_colliders(SCP_vector<int> *overlap_list_out, SCP_vector<int> *list, int axis, bool collide);
 //float obj_get_collider_endpoint(int obj_num, int axis, bool min);
@@ -23,6 +23,7 @@
 #include "mission/missionparse.h" //For 2D Mode
 #include "network/multi.h"
 #include "network/multiutil.h"
+#include "network/multi_obj.h"
 #include "object/objcollide.h"
 #include "object/object.h"
 #include "object/objectdock.h"
@@ -1195,7 +1196,7 @@ void obj_move_all_post(object *objp, float frametime)
 		{
 			if ( !physics_paused || (objp==Player_obj) ) {
 				ship_process_post( objp, frametime );
-				ship_model_update_instance(objp);
+				ship_process_post_local( objp, frametime );
 			}
 
 			// Make any electrical arcs on ships cast light
@@ -1376,6 +1377,9 @@ void obj_move_all(float frametime)
 
 	MONITOR_INC( NumObjects, Num_objects );	
 
+	// the ships' own post-move work is done in one go, after the loop
+	ship_defer_post_local(frametime);
+
 	for (objp = GET_FIRST(&obj_used_list); objp != END_OF_LIST(&obj_used_list); objp = GET_NEXT(objp)) {
 		// skip objects which should be dead
 		if (objp->flags & OF_SHOULD_BE_DEAD) {
@@ -1431,6 +1435,8 @@ void obj_move_all(float frametime)
 		}
 	}
 
+	PROFILE("Ship Post Move", ship_finish_post_local());
+
 	//	After all objects have been moved, move all docked objects.
 	objp = GET_FIRST(&obj_used_list);
 	while( objp !=END_OF_LIST(&obj_used_list) )	{
@@ -1475,10 +1481,16 @@ void obj_move_all(float frametime)
 
 	find_homing_object_cmeasures();	//	If any cmeasures fired, maybe steer away homing missiles	
 
+	// remember where all ships are this frame so client weapon hits can be checked against the past
+	if (MULTIPLAYER_MASTER) {
+		multi_oo_history_record();
+	}
+
 	// do pre-collision stuff for beam weapons
 	beam_move_all_pre();
 
-	profile_begin("Collision Detection");
+	static int collision_site = profile_site("Collision Detection");
+	profile_begin(collision_site);
 	if (Collisions_enabled) {
 #ifdef MULTITHREADING_NARROWPHASE_COLLISIONS
 		if (Cmdline_num_threads > 1) {
@@ -1493,7 +1505,7 @@ void obj_move_all(float frametime)
 		}
 #endif
 	}
-	profile_end("Collision Detection");
+	profile_end(collision_site);
 
 	turret_swarm_check_validity();
 
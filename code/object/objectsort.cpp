@@ -16,141 +16,259 @@
 #include "nebula/neb.h"
 #include "ship/ship.h"
 
-#include <vector>
-#include <algorithm>
+#include "render/3dinternal.h"
 #include "weapon/weapon.h"
 #include "debris/debris.h"
 #include "asteroid/asteroid.h"
 
+#include <float.h>
+
+#if (_M_IX86_FP >= 1) || defined(_M_X64) || defined(__SSE__)
+	#include <xmmintrin.h>
+	#define OBJSORT_USE_SSE
+#endif
+
 
 class sorted_obj
 {
 public:
 	object			*obj;					// a pointer to the original object
 	float			z, min_z, max_z;		// The object's z values relative to viewer
+	uint			model_key;				// objects are drawn grouped by model ...
+	uint			depth_key;				// ... and back to front within each group
 
 	sorted_obj() :
-		obj(NULL), z(0.0f), min_z(0.0f), max_z(1.0f)
+		obj(NULL), z(0.0f), min_z(0.0f), max_z(1.0f), model_key(0), depth_key(0)
 	{
 	}
-
-	bool operator < (const sorted_obj &other) const;
 };
 
-inline bool sorted_obj::operator < (const sorted_obj &other) const
+SCP_vector<sorted_obj> Sorted_objects;
+SCP_vector<object*> effect_ships; 
+
+// Candidates for rendering, packed so that the view cone test can go through them four at a time
+static SCP_vector<float> Cull_x, Cull_y, Cull_z, Cull_radius, Cull_depth;
+static SCP_vector<ubyte> Cull_visible;
+static SCP_vector<object*> Cull_objects;
+static SCP_vector<sorted_obj> Sort_scratch;
+
+#define MAX_CULL_PLANES		6
+
+// The planes bounding the view cone in world space, pointing out of it.  A sphere is outside if
+// normal . center + dist > radius for any of them.
+typedef struct cull_frustum {
+	int		num_planes;
+	float	nx[MAX_CULL_PLANES], ny[MAX_CULL_PLANES], nz[MAX_CULL_PLANES], dist[MAX_CULL_PLANES];
+} cull_frustum;
+
+static void obj_cull_add_plane(cull_frustum *cf, vec3d *normal, vec3d *point)
 {
-	int model_num_a = -1;
-	int model_num_b = -1;
+	vec3d n = *normal;
 
-	if ( obj->type == OBJ_SHIP ) {
-		ship_info *sip = &Ship_info[Ships[obj->instance].ship_info_index];
+	if (vm_vec_mag_squared(&n) <= 0.0f)
+		return;
 
-		model_num_a = sip->model_num;
-	} else if ( obj->type == OBJ_WEAPON ){
-		weapon_info *wip;
-		weapon *wp;
+	vm_vec_normalize(&n);
 
-		wp = &Weapons[obj->instance];
-		wip = &Weapon_info[Weapons[obj->instance].weapon_info_index];
+	cf->nx[cf->num_planes] = n.xyz.x;
+	cf->ny[cf->num_planes] = n.xyz.y;
+	cf->nz[cf->num_planes] = n.xyz.z;
+	cf->dist[cf->num_planes] = -vm_vec_dot(&n, point);
+	cf->num_planes++;
+}
 
-		if ( wip->render_type == WRT_POF ) {
-			model_num_a = wip->model_num;
-		}
-	} else if ( obj->type == OBJ_DEBRIS ) {
-		debris		*db;
+// Same cone as the clip codes from g3_rotate_vector(): x and y within +/- z of the scaled view matrix,
+// z in front of the eye, and the user clip plane if there is one.
+static void obj_cull_setup_frustum(cull_frustum *cf)
+{
+	vec3d n;
+	vec3d *rvec = &View_matrix.vec.rvec;
+	vec3d *uvec = &View_matrix.vec.uvec;
+	vec3d *fvec = &View_matrix.vec.fvec;
 
-		db = &Debris[obj->instance];
-		model_num_a = db->model_num;
-	} else if ( obj->type == OBJ_ASTEROID ) {
-		asteroid		*asp;
+	cf->num_planes = 0;
+
+	vm_vec_sub(&n, rvec, fvec);				// CC_OFF_RIGHT
+	obj_cull_add_plane(cf, &n, &View_position);
 
-		asp = &Asteroids[obj->instance];
-		model_num_a = Asteroid_info[asp->asteroid_type].model_num[asp->asteroid_subtype];
+	vm_vec_add(&n, rvec, fvec);				// CC_OFF_LEFT
+	vm_vec_negate(&n);
+	obj_cull_add_plane(cf, &n, &View_position);
+
+	vm_vec_sub(&n, uvec, fvec);				// CC_OFF_TOP
+	obj_cull_add_plane(cf, &n, &View_position);
+
+	vm_vec_add(&n, uvec, fvec);				// CC_OFF_BOT
+	vm_vec_negate(&n);
+	obj_cull_add_plane(cf, &n, &View_position);
+
+	n = *fvec;								// CC_BEHIND
+	vm_vec_negate(&n);
+	obj_cull_add_plane(cf, &n, &View_position);
+
+	if (G3_user_clip) {						// CC_OFF_USER
+		n = G3_user_clip_normal;
+		vm_vec_negate(&n);
+		obj_cull_add_plane(cf, &n, &G3_user_clip_point);
 	}
+}
 
-	if ( other.obj->type == OBJ_SHIP ) {
-		ship_info *sip = &Ship_info[Ships[other.obj->instance].ship_info_index];
+// See if an object is in the view cone.
+// Returns:
+// 0 if object isn't in the view cone
+// 1 if object is in cone 
+int obj_in_view_cone( object * objp )
+{
+	cull_frustum cf;
 
-		model_num_b = sip->model_num;
-	} else if ( other.obj->type == OBJ_WEAPON ){
-		weapon_info *wip;
-		weapon *wp;
+	obj_cull_setup_frustum(&cf);
 
-		wp = &Weapons[other.obj->instance];
-		wip = &Weapon_info[Weapons[other.obj->instance].weapon_info_index];
+	for (int i = 0; i < cf.num_planes; i++) {
+		float d = cf.nx[i]*objp->pos.xyz.x + cf.ny[i]*objp->pos.xyz.y + cf.nz[i]*objp->pos.xyz.z + cf.dist[i];
 
-		if ( wip->render_type == WRT_POF ) {
-			model_num_b = wip->model_num;
+		if (d > objp->radius)
+			return 0;
+	}
+
+	return 1;
+}
+
+// Runs the view cone test over all the packed candidates, and gets their depths along the eye vector.
+// Expects the arrays to be padded to a multiple of 4.
+static void obj_cull_all(cull_frustum *cf)
+{
+	int count = (int)Cull_x.size();
+	int i, p;
+
+	float fx = Eye_matrix.vec.fvec.xyz.x;
+	float fy = Eye_matrix.vec.fvec.xyz.y;
+	float fz = Eye_matrix.vec.fvec.xyz.z;
+	float fd = -vm_vec_dot(&Eye_matrix.vec.fvec, &Eye_position);
+
+#ifdef OBJSORT_USE_SSE
+	for (i = 0; i < count; i += 4) {
+		__m128 x = _mm_loadu_ps(&Cull_x[i]);
+		__m128 y = _mm_loadu_ps(&Cull_y[i]);
+		__m128 z = _mm_loadu_ps(&Cull_z[i]);
+		__m128 r = _mm_loadu_ps(&Cull_radius[i]);
+		__m128 outside = _mm_setzero_ps();
+
+		for (p = 0; p < cf->num_planes; p++) {
+			__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(cf->nx[p])), _mm_mul_ps(y, _mm_set1_ps(cf->ny[p]))),
+				_mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(cf->nz[p])), _mm_set1_ps(cf->dist[p])));
+
+			outside = _mm_or_ps(outside, _mm_cmpgt_ps(d, r));
 		}
-	} else if ( other.obj->type == OBJ_DEBRIS ) {
-		debris		*db;
 
-		db = &Debris[other.obj->instance];
-		model_num_b = db->model_num;
-	} else if ( other.obj->type == OBJ_ASTEROID ) {
-		asteroid		*asp;
+		__m128 depth = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(fx)), _mm_mul_ps(y, _mm_set1_ps(fy))),
+			_mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(fz)), _mm_set1_ps(fd)));
+		_mm_storeu_ps(&Cull_depth[i], depth);
 
-		asp = &Asteroids[other.obj->instance];
-		model_num_b = Asteroid_info[asp->asteroid_type].model_num[asp->asteroid_subtype];
+		int mask = _mm_movemask_ps(outside);
+
+		Cull_visible[i] = !(mask & 1);
+		Cull_visible[i+1] = !(mask & 2);
+		Cull_visible[i+2] = !(mask & 4);
+		Cull_visible[i+3] = !(mask & 8);
+	}
+#else
+	for (i = 0; i < count; i += 4) {
+		ubyte outside[4] = { 0, 0, 0, 0 };
+		int k;
+
+		for (p = 0; p < cf->num_planes; p++) {
+			for (k = 0; k < 4; k++) {
+				float d = Cull_x[i+k]*cf->nx[p] + Cull_y[i+k]*cf->ny[p] + Cull_z[i+k]*cf->nz[p] + cf->dist[p];
+
+				outside[k] |= (d > Cull_radius[i+k]);
+			}
+		}
+
+		for (k = 0; k < 4; k++) {
+			Cull_depth[i+k] = Cull_x[i+k]*fx + Cull_y[i+k]*fy + Cull_z[i+k]*fz + fd;
+			Cull_visible[i+k] = !outside[k];
+		}
 	}
+#endif
+}
+
+static int obj_render_model_num(object *obj)
+{
+	if ( obj->type == OBJ_SHIP ) {
+		return Ship_info[Ships[obj->instance].ship_info_index].model_num;
+	} else if ( obj->type == OBJ_WEAPON ) {
+		weapon_info *wip = &Weapon_info[Weapons[obj->instance].weapon_info_index];
 
-	if ( model_num_a == model_num_b ) {
-		return (max_z > other.max_z);
+		if ( wip->render_type == WRT_POF ) {
+			return wip->model_num;
+		}
+	} else if ( obj->type == OBJ_DEBRIS ) {
+		return Debris[obj->instance].model_num;
+	} else if ( obj->type == OBJ_ASTEROID ) {
+		asteroid *asp = &Asteroids[obj->instance];
+
+		return Asteroid_info[asp->asteroid_type].model_num[asp->asteroid_subtype];
 	}
 
-	return model_num_a < model_num_b;
+	return -1;
 }
 
+// maps a float to an unsigned int with the same ordering
+static inline uint obj_sort_float_key(float f)
+{
+	uint u;
 
-SCP_vector<sorted_obj> Sorted_objects;
-SCP_vector<object*> effect_ships; 
+	memcpy(&u, &f, sizeof(u));
 
-// Used to (fairly) quicky find the 8 extreme
-// points around an object.
-vec3d check_offsets[8] = { 
-  { { { -1.0f, -1.0f, -1.0f } } },
-  { { { -1.0f, -1.0f,  1.0f } } },
-  { { { -1.0f,  1.0f, -1.0f } } },
-  { { { -1.0f,  1.0f,  1.0f } } },
-  { { {  1.0f, -1.0f, -1.0f } } },
-  { { {  1.0f, -1.0f,  1.0f } } },
-  { { {  1.0f,  1.0f, -1.0f } } },
-  { { {  1.0f,  1.0f,  1.0f } } }
-};
+	return (u & 0x80000000) ? ~u : (u | 0x80000000);
+}
 
-// See if an object is in the view cone.
-// Returns:
-// 0 if object isn't in the view cone
-// 1 if object is in cone 
-// This routine could possibly be optimized.  Right now, for an
-// offscreen object, it has to rotate 8 points to determine it's
-// offscreen.  Not the best considering we're looking at a sphere.
-int obj_in_view_cone( object * objp )
+// LSD radix sort of Sorted_objects, a byte at a time: depth first, then model.  Bytes that are the same
+// for every object are skipped, which leaves only one or two passes for the model key.
+static void obj_sort_radix()
 {
-	int i;
-	vec3d tmp,pt;
-	ubyte codes;
-
-	// Center isn't in... are other points?
-	ubyte and_codes = 0xff;
-
-	for (i=0; i<8; i++ ) {
-		vm_vec_scale_add( &pt, &objp->pos, &check_offsets[i], objp->radius );
-		codes=g3_rotate_vector(&tmp,&pt);
-		if ( !codes ) {
-			//mprintf(( "A point is inside, so render it.\n" ));
-			return 1;		// this point is in, so return 1
+	size_t count = Sorted_objects.size();
+	size_t i;
+
+	Sort_scratch.resize(count);
+
+	sorted_obj *src = &Sorted_objects[0];
+	sorted_obj *dst = &Sort_scratch[0];
+
+	for (int pass = 0; pass < 6; pass++) {
+		uint offsets[256];
+		int shift = (pass & 3) * 8;
+		bool model_pass = (pass >= 4);
+
+		memset(offsets, 0, sizeof(offsets));
+
+		for (i = 0; i < count; i++) {
+			uint key = model_pass ? src[i].model_key : src[i].depth_key;
+			offsets[(key >> shift) & 0xff]++;
 		}
-		and_codes &= codes;
-	}
 
-	if (and_codes) {
-		//mprintf(( "All points offscreen, so don't render it.\n" ));
-		return 0;	//all points off screen
+		if (offsets[((model_pass ? src[0].model_key : src[0].depth_key) >> shift) & 0xff] == count)
+			continue;
+
+		uint total = 0;
+		for (i = 0; i < 256; i++) {
+			uint n = offsets[i];
+			offsets[i] = total;
+			total += n;
+		}
+
+		for (i = 0; i < count; i++) {
+			uint key = model_pass ? src[i].model_key : src[i].depth_key;
+			dst[offsets[(key >> shift) & 0xff]++] = src[i];
+		}
+
+		sorted_obj *tmp = src;
+		src = dst;
+		dst = tmp;
 	}
 
-	//mprintf(( "All points inside, so render it, but doesn't need clipping.\n" ));
-	return 1;
+	if (src != &Sorted_objects[0])
+		Sorted_objects.swap(Sort_scratch);
 }
 
 inline bool obj_render_is_model(object *obj)
@@ -177,53 +295,90 @@ void obj_render_all(void (*render_function)(object *objp), bool *draw_viewer_las
 	float farthest_obj = Min_draw_distance;
 #endif
 
+	Cull_x.clear();
+	Cull_y.clear();
+	Cull_z.clear();
+	Cull_radius.clear();
+	Cull_objects.clear();
+
 	objp = Objects;
 
 	for (i=0;i<=Highest_object_index;i++,objp++) {
 		if ( (objp->type != OBJ_NONE) && (objp->flags&OF_RENDERS) )	{
 			objp->flags &= ~OF_WAS_RENDERED;
 
-			if ( obj_in_view_cone(objp) )	{
-				sorted_obj osp;
+			Cull_x.push_back(objp->pos.xyz.x);
+			Cull_y.push_back(objp->pos.xyz.y);
+			Cull_z.push_back(objp->pos.xyz.z);
+			Cull_radius.push_back(objp->radius);
+			Cull_objects.push_back(objp);
+		}
+	}
+
+	if ( Cull_objects.empty() )
+		return;
+
+	// pad to a multiple of four with spheres that are never in view
+	while (Cull_x.size() & 3) {
+		Cull_x.push_back(0.0f);
+		Cull_y.push_back(0.0f);
+		Cull_z.push_back(0.0f);
+		Cull_radius.push_back(-FLT_MAX);
+	}
+
+	Cull_depth.resize(Cull_x.size());
+	Cull_visible.resize(Cull_x.size());
+
+	cull_frustum cf;
+	obj_cull_setup_frustum(&cf);
+	obj_cull_all(&cf);
+
+	for (i = 0; i < (int)Cull_objects.size(); i++) {
+		if ( !Cull_visible[i] )
+			continue;
+
+		objp = Cull_objects[i];
 
-				osp.obj = objp;
+		sorted_obj osp;
 
-				vec3d to_obj;
-				vm_vec_sub( &to_obj, &objp->pos, &Eye_position );
-				osp.z = vm_vec_dot( &Eye_matrix.vec.fvec, &to_obj );
+		osp.obj = objp;
+		osp.z = Cull_depth[i];
 /*
-				if ( objp->type == OBJ_SHOCKWAVE )
-					osp.z -= 2*objp->radius;
+		if ( objp->type == OBJ_SHOCKWAVE )
+			osp.z -= 2*objp->radius;
 */
-				// Make warp in effect draw after any ship in it
-				if ( objp->type == OBJ_FIREBALL )	{
-					//if ( fireball_is_warp(objp) )	{
-					osp.z -= 2*objp->radius;
-					//}
-				}
-					
-				osp.min_z = osp.z - objp->radius;
-				osp.max_z = osp.z + objp->radius;
-
-				Sorted_objects.push_back(osp);
+		// Make warp in effect draw after any ship in it
+		if ( objp->type == OBJ_FIREBALL )	{
+			//if ( fireball_is_warp(objp) )	{
+			osp.z -= 2*objp->radius;
+			//}
+		}
+			
+		osp.min_z = osp.z - objp->radius;
+		osp.max_z = osp.z + objp->radius;
+
+		int model_num = obj_render_model_num(objp);
+
+		osp.model_key = (model_num < 0) ? 0 : (uint)(model_num % MAX_POLYGON_MODELS) + 1;
+		osp.depth_key = ~obj_sort_float_key(osp.max_z);
+
+		Sorted_objects.push_back(osp);
 
 #ifdef DYN_CLIP_DIST
-				if(objp != Viewer_obj)
-				{
-					if(osp->min_z < closest_obj)
-						closest_obj = osp->min_z;
-					if(osp->max_z > farthest_obj)
-						farthest_obj = osp->max_z;
-				}
+		if(objp != Viewer_obj)
+		{
+			if(osp->min_z < closest_obj)
+				closest_obj = osp->min_z;
+			if(osp->max_z > farthest_obj)
+				farthest_obj = osp->max_z;
+		}
 #endif
-			}
-		}	
 	}
 
 	if ( Sorted_objects.empty() )
 		return;
 
-	std::sort(Sorted_objects.begin(), Sorted_objects.end());
+	obj_sort_radix();
 
 #ifdef DYN_CLIP_DIST
 	if (!Cmdline_nohtl)
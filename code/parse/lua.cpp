@@ -3229,6 +3229,7 @@ ADE_VIRTVAR(Name, l_Species, "string", "Species name", "string", "Species name,
 
 	if(ADE_SETTING_VAR && s != NULL) {
 		strncpy(Species_info[idx].species_name, s, sizeof(Species_info[idx].species_name)-1);
+		species_info_lookup_invalidate();
 	}
 
 	return ade_set_args(L, "s", Species_info[idx].species_name);
@@ -3270,6 +3271,7 @@ ADE_VIRTVAR(Name, l_Team, "string", "Team name", "string", "Team name, or empty
 
 	if(ADE_SETTING_VAR && s != NULL) {
 		strncpy(Iff_info[tdx].iff_name, s, NAME_LENGTH-1);
+		iff_lookup_invalidate();
 	}
 
 	return ade_set_args(L, "s", Iff_info[tdx].iff_name);
@@ -3903,6 +3905,7 @@ ADE_VIRTVAR(Name, l_Weaponclass, "string", "Weapon class name", "string", "Weapo
 
 	if(ADE_SETTING_VAR && s != NULL) {
 		strncpy(Weapon_info[idx].name, s, sizeof(Weapon_info[idx].name)-1);
+		weapon_info_lookup_invalidate();
 	}
 
 	return ade_set_args(L, "s", Weapon_info[idx].name);
@@ -5606,6 +5609,7 @@ ADE_VIRTVAR(Name, l_Shipclass, "string", "Ship class name", "string", "Ship clas
 
 	if(ADE_SETTING_VAR && s != NULL) {
 		strncpy(Ship_info[idx].name, s, sizeof(Ship_info[idx].name)-1);
+		ship_info_lookup_invalidate();
 	}
 
 	return ade_set_args(L, "s", Ship_info[idx].name);
@@ -15450,6 +15454,51 @@ int ade_get_args(lua_State *L, char *fmt, ...)
 	return counted_args;
 }
 
+//Object handles (object_h and the types deriving from l_Object) are
+//immutable once pushed, so every reference to the same object can share
+//one userdata. This saves a lua_newuserdata and a metatable lookup each
+//time a hook or iterator hands the same object back to a script.
+static bool ade_is_object_handle_type(uint idx)
+{
+	uint obj_idx = l_Object.GetIdx();
+	while(idx != UINT_MAX)
+	{
+		if(idx == obj_idx)
+			return true;
+		idx = Ade_table_entries[idx].DerivatorIdx;
+	}
+	return false;
+}
+
+//Pushes the weak-valued handle cache for the given type, creating it
+//in the registry if needed. Keys are object signatures.
+static void ade_push_handle_cache(lua_State *L, uint idx)
+{
+	lua_getfield(L, LUA_REGISTRYINDEX, "ade_handle_cache");
+	if(!lua_istable(L, -1))
+	{
+		lua_pop(L, 1);
+		lua_newtable(L);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, LUA_REGISTRYINDEX, "ade_handle_cache");
+	}
+
+	lua_rawgeti(L, -1, (int)idx);
+	if(!lua_istable(L, -1))
+	{
+		lua_pop(L, 1);
+		lua_newtable(L);
+		//Let the collector drop handles no script holds anymore
+		lua_createtable(L, 0, 1);
+		lua_pushstring(L, "v");
+		lua_setfield(L, -2, "__mode");
+		lua_setmetatable(L, -2);
+		lua_pushvalue(L, -1);
+		lua_rawseti(L, -3, (int)idx);
+	}
+	lua_remove(L, -2);	//ade_handle_cache
+}
+
 //ade_set_args(state, arguments, variables)
 //----------------------------------------------
 //based on "Programming in Lua"
@@ -15507,6 +15556,31 @@ int ade_set_args(lua_State *L, char *fmt, ...)
 					//Copy over objectdata
 					ade_odata od = (ade_odata) va_arg(vl, ade_odata);
 
+					ODATA_SIG_TYPE tempsig = ODATA_SIG_DEFAULT;
+					if(od.sig != NULL)
+						tempsig = *od.sig;
+
+					//Reuse the handle already given out for this object, if it is still alive
+					int cache_key = 0;
+					if(ade_is_object_handle_type(od.idx))
+					{
+						object_h *oh = (object_h*)od.buf;
+						if(oh->objp != NULL)
+							cache_key = oh->sig;
+					}
+					if(cache_key != 0)
+					{
+						ade_push_handle_cache(L, od.idx);
+						lua_rawgeti(L, -1, cache_key);
+						char *oldod = (char*)lua_touserdata(L, -1);
+						if(oldod != NULL && !memcmp(oldod, od.buf, od.size) && !memcmp(oldod + od.size, &tempsig, sizeof(ODATA_SIG_TYPE)))
+						{
+							lua_remove(L, -2);	//cache
+							break;
+						}
+						lua_pop(L, 1);
+					}
+
 					//Create new LUA object and get handle
 					char *newod = (char*)lua_newuserdata(L, od.size + sizeof(ODATA_SIG_TYPE));
 					//Create or get object metatable
@@ -15518,12 +15592,13 @@ int ade_set_args(lua_State *L, char *fmt, ...)
 					memcpy(newod, od.buf, od.size);
 
 					//Also copy in the unique sig
-					if(od.sig != NULL)
-						memcpy(newod + od.size, od.sig, sizeof(ODATA_SIG_TYPE));
-					else
+					memcpy(newod + od.size, &tempsig, sizeof(ODATA_SIG_TYPE));
+
+					if(cache_key != 0)
 					{
-						ODATA_SIG_TYPE tempsig = ODATA_SIG_DEFAULT;
-						memcpy(newod + od.size, &tempsig, sizeof(ODATA_SIG_TYPE));
+						lua_pushvalue(L, -1);
+						lua_rawseti(L, -3, cache_key);
+						lua_remove(L, -2);	//cache
 					}
 					break;
 				}
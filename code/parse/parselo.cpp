@@ -13,6 +13,8 @@
 #include <assert.h>
 #include <stdarg.h>
 #include <setjmp.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include "parse/parselo.h"
 #include "parse/sexp.h"
@@ -31,30 +33,32 @@
 #define	ERROR_LENGTH	64
 #define	RS_MAX_TRIES	5
 
+// All of the parser state below is per thread, so a worker thread can read and
+// parse a file of its own while the main thread is busy with another one.
+
 // to know that a modular table is currently being parsed
-bool	Parsing_modular_table = false;
-
-char		Current_filename[128];
-char		Current_filename_save[128];
-char		Current_filename_sub[128];	//Last attempted file to load, don't know if ex or not.
-char		Error_str[ERROR_LENGTH];
-int		my_errno;
-int		Warning_count, Error_count;
-int		Warning_count_save = 0, Error_count_save = 0;
+SCP_THREAD_LOCAL bool	Parsing_modular_table = false;
+
+SCP_THREAD_LOCAL char		Current_filename[128];
+SCP_THREAD_LOCAL char		Current_filename_sub[128];	//Last attempted file to load, don't know if ex or not.
+SCP_THREAD_LOCAL char		Error_str[ERROR_LENGTH];
+SCP_THREAD_LOCAL int		my_errno;
+SCP_THREAD_LOCAL int		Warning_count, Error_count;
 int		fred_parse_flag = 0;
-int		Token_found_flag;
-jmp_buf	parse_abort;
+SCP_THREAD_LOCAL int		Token_found_flag;
+SCP_THREAD_LOCAL jmp_buf	parse_abort;
 
-char 	*Mission_text = NULL;
-char	*Mission_text_raw = NULL;
-char	*Mp = NULL, *Mp_save = NULL;
-char	*token_found;
+SCP_THREAD_LOCAL char 	*Mission_text = NULL;
+SCP_THREAD_LOCAL char	*Mission_text_raw = NULL;
+SCP_THREAD_LOCAL char	*Mp = NULL;
+SCP_THREAD_LOCAL char	*token_found;
 
-static int Parsing_paused = 0;
+static SCP_THREAD_LOCAL int Parsing_paused = 0;
+static SCP_THREAD_LOCAL parse_context Parse_paused_context;
 
 // text allocation stuff
 void allocate_mission_text(int size);
-static int Mission_text_size = 0;
+static SCP_THREAD_LOCAL int Mission_text_size = 0;
 
 
 //	Return true if this character is white space, else false.
@@ -1890,6 +1894,133 @@ int parse_get_line(char *lineout, int max_line_len, char *start, int max_size, c
 	return  num_chars_read;
 }
 
+// Table cache.  Tables hardly ever change between runs, so the comment-stripped
+// text of each one is kept in the cache directory along with where the table was
+// found and that file's size and write time.  If none of those have changed, the
+// cached copy is read instead of the raw table, and process_raw_file_text() is
+// skipped.  A table inside a VP is keyed on the VP's write time and its offset.
+#define TABLE_CACHE_ID			0x54424320	// "TBC " - ("  CBT" in file)
+#define TABLE_CACHE_VERSION		2
+
+extern int Cmdline_notablecache;
+
+typedef struct table_cache_key {
+	char	location[CF_MAX_PATHNAME_LENGTH];	// loose file or VP the table was found in
+	int		offset;						// offset into the VP, 0 for a loose file
+	int		size;
+	int		write_time;
+} table_cache_key;
+
+static void table_cache_filename(const char *filename, char *out, size_t out_size)
+{
+	char *p;
+
+	strcpy_s(out, out_size, filename);
+	while ((p = strchr(out, '.')) != NULL)
+		*p = '_';
+	strcat_s(out, out_size, NOX(".tbc"));
+}
+
+static bool table_cache_get_key(const char *filename, int mode, table_cache_key *key)
+{
+	struct stat buf;
+
+	memset(key, 0, sizeof(table_cache_key));
+
+	if ( !cf_find_file_location(filename, mode, sizeof(key->location) - 1, key->location, &key->size, &key->offset) )
+		return false;
+
+	if ( stat(key->location, &buf) != 0 )
+		return false;
+
+	key->write_time = (int)buf.st_mtime;
+
+	return true;
+}
+
+// on success the processed text is in Mission_text and the raw text is empty
+static bool table_cache_read(const char *filename, const table_cache_key *key)
+{
+	char cache_name[MAX_FILENAME_LEN + 8];
+	char location[CF_MAX_PATHNAME_LENGTH];
+	table_cache_filename(filename, cache_name, sizeof(cache_name));
+
+	CFILE *cfp = cfopen(cache_name, "rb", CFILE_NORMAL, CF_TYPE_CACHE);
+	if (cfp == NULL)
+		return false;
+
+	bool valid = false;
+	int cache_len = cfilelength(cfp);
+
+	if ( (cache_len > 6 * (int)sizeof(int))
+		&& (cfread_int(cfp) == TABLE_CACHE_ID)
+		&& (cfread_int(cfp) == TABLE_CACHE_VERSION)
+		&& (cfread_int(cfp) == (Fred_running ? 1 : 0))
+		&& (cfread_int(cfp) == key->offset)
+		&& (cfread_int(cfp) == key->size)
+		&& (cfread_int(cfp) == key->write_time) )
+	{
+		int location_len = cfread_int(cfp);
+
+		if ( (location_len >= 0) && (location_len < (int)sizeof(location)) )
+		{
+			if (location_len > 0)
+				cfread(location, location_len, 1, cfp);
+			location[location_len] = '\0';
+		}
+		else
+			location[0] = '\0';
+
+		int processed_len = cfread_int(cfp);
+
+		if ( !stricmp(location, key->location) && (processed_len >= 0)
+			&& (processed_len == cache_len - cftell(cfp)) )
+		{
+			allocate_mission_text( MAX(processed_len, key->size) + 1 );
+
+			valid = (processed_len == 0) || (cfread(Mission_text, processed_len, 1, cfp) == 1);
+			Mission_text[processed_len] = EOF_CHAR;
+
+			// the raw text isn't kept, and nothing reads it after processing
+			Mission_text_raw[0] = EOF_CHAR;
+		}
+	}
+
+	cfclose(cfp);
+
+	if (!valid)
+		mprintf(("TABLE CACHE: Cached copy of '%s' is out of date\n", filename));
+
+	return valid;
+}
+
+static void table_cache_write(const char *filename, const table_cache_key *key)
+{
+	char cache_name[MAX_FILENAME_LEN + 8];
+	table_cache_filename(filename, cache_name, sizeof(cache_name));
+
+	CFILE *cfp = cfopen(cache_name, "wb", CFILE_NORMAL, CF_TYPE_CACHE);
+	if (cfp == NULL)
+		return;
+
+	int processed_len = 0;
+	while (Mission_text[processed_len] != EOF_CHAR)
+		processed_len++;
+
+	cfwrite_int(TABLE_CACHE_ID, cfp);
+	cfwrite_int(TABLE_CACHE_VERSION, cfp);
+	cfwrite_int(Fred_running ? 1 : 0, cfp);
+	cfwrite_int(key->offset, cfp);
+	cfwrite_int(key->size, cfp);
+	cfwrite_int(key->write_time, cfp);
+	cfwrite_string_len(key->location, cfp);
+	cfwrite_int(processed_len, cfp);
+	if (processed_len > 0)
+		cfwrite(Mission_text, processed_len, 1, cfp);
+
+	cfclose(cfp);
+}
+
 //	Read mission text, stripping comments.
 //	When a comment is found, it is removed.  If an entire line
 //	consisted of a comment, a blank line is left in the input file.
@@ -1906,6 +2037,15 @@ void read_file_text(const char *filename, int mode, char *processed_text, char *
 		Error(LOCATION, "ERROR: Neither processed_text nor raw_text may be NULL when parsing is paused!!\n");
 	}
 
+	// tables that haven't changed can come straight from the cache, without
+	// reading the raw file at all
+	table_cache_key key;
+	bool use_cache = (mode == CF_TYPE_TABLES) && (processed_text == NULL) && (raw_text == NULL)
+		&& !Cmdline_notablecache && table_cache_get_key(filename, mode, &key);
+
+	if ( use_cache && table_cache_read(filename, &key) )
+		return;
+
 	// read the raw text
 	read_raw_file_text(filename, mode, raw_text);
 
@@ -1917,6 +2057,9 @@ void read_file_text(const char *filename, int mode, char *processed_text, char *
 
 	// process it (strip comments)
 	process_raw_file_text(processed_text, raw_text);
+
+	if (use_cache)
+		table_cache_write(filename, &key);
 }
 
 // Goober5000
@@ -1994,6 +2137,7 @@ void allocate_mission_text(int size)
 		return;
 
 
+	// only covers the thread that first allocates; worker threads call stop_parse() themselves
 	static ubyte parse_atexit = 0;
 
 	if (!parse_atexit) {
@@ -3144,6 +3288,28 @@ void find_and_stuff_or_add(char *id, int *addr, int f_type, char *strlist[], int
 	}
 }
 
+// save the position and error state of the file being parsed on this thread
+void parse_context_save(parse_context *pc)
+{
+	Assert( pc != NULL );
+
+	pc->Mp = Mp;
+	pc->Warning_count = Warning_count;
+	pc->Error_count = Error_count;
+	strcpy_s(pc->Current_filename, Current_filename);
+}
+
+// resume a file previously saved with parse_context_save()
+void parse_context_restore(const parse_context *pc)
+{
+	Assert( pc != NULL );
+
+	Mp = pc->Mp;
+	Warning_count = pc->Warning_count;
+	Error_count = pc->Error_count;
+	strcpy_s(Current_filename, pc->Current_filename);
+}
+
 // pause current parsing so that some else can be parsed without interfering
 // with the currently parsing file
 void pause_parse()
@@ -3152,12 +3318,7 @@ void pause_parse()
 	if (Parsing_paused)
 		return;
 
-	Mp_save = Mp;
-
-	Warning_count_save = Warning_count;
-	Error_count_save = Error_count;
-
-	strcpy_s(Current_filename_save, Current_filename);
+	parse_context_save(&Parse_paused_context);
 
 	Parsing_paused = 1;	
 }
@@ -3169,12 +3330,7 @@ void unpause_parse()
 	if (!Parsing_paused)
 		return;
 
-	Mp = Mp_save;
-
-	Warning_count = Warning_count_save;
-	Error_count = Error_count_save;
-
-	strcpy_s(Current_filename, Current_filename_save);
+	parse_context_restore(&Parse_paused_context);
 
 	Parsing_paused = 0;
 }
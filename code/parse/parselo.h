@@ -21,15 +21,26 @@
 // NOTE: although the main game doesn't need this anymore, FRED2 still does
 #define	MISSION_TEXT_SIZE	1000000
 
-extern char	*Mission_text;
-extern char	*Mission_text_raw;
-extern char	*Mp;
-extern char	*token_found;
+// parser state is per thread (see parse_context below)
+extern SCP_THREAD_LOCAL char	*Mission_text;
+extern SCP_THREAD_LOCAL char	*Mission_text_raw;
+extern SCP_THREAD_LOCAL char	*Mp;
+extern SCP_THREAD_LOCAL char	*token_found;
 extern int fred_parse_flag;
-extern int Token_found_flag;
-extern jmp_buf parse_abort;
+extern SCP_THREAD_LOCAL int Token_found_flag;
+extern SCP_THREAD_LOCAL jmp_buf parse_abort;
 
 
+// Where a file is being parsed, so that it can be put aside and picked up again later.
+// The parser globals themselves are thread local, so each thread parses independently;
+// worker threads should call stop_parse() before exiting to free their text buffers.
+typedef struct parse_context {
+	char	*Mp;
+	int		Warning_count;
+	int		Error_count;
+	char	Current_filename[128];
+} parse_context;
+
 #define	COMMENT_CHAR	(char)';'
 #define	EOF_CHAR			(char)-128
 #define	EOLN				(char)0x0a
@@ -180,7 +191,9 @@ extern void reset_parse(char *text = NULL);
 extern void display_parse_diagnostics();
 extern void pause_parse();
 extern void unpause_parse();
-// stop parsing, basically just free's up the memory from Mission_text and Mission_text_raw
+extern void parse_context_save(parse_context *pc);
+extern void parse_context_restore(const parse_context *pc);
+// stop parsing, basically just free's up the memory from Mission_text and Mission_text_raw (for the calling thread)
 extern void stop_parse();
 
 // utility
@@ -250,7 +263,7 @@ inline void parse_advance(int s){Mp+=s;}
 // parse a modular table, returns the number of files matching the "name_check" filter or 0 if it did nothing
 extern int parse_modular_table(const char *name_check, void (*parse_callback)(const char *filename), int path_type = CF_TYPE_TABLES, int sort_type = CF_SORT_REVERSE);
 // to know that we are parsing a modular table
-extern bool Parsing_modular_table;
+extern SCP_THREAD_LOCAL bool Parsing_modular_table;
 
 //Karajorma - Parses mission and campaign ship loadouts. 
 int stuff_loadout_list (int *ilp, int max_ints, int lookup_type);
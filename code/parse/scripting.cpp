@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdarg.h>
+#include <algorithm>
 #include "parse/scripting.h"
 #include "parse/lua.h"
 #include "parse/parselo.h"
@@ -16,6 +17,8 @@
 #include "freespace2/freespace.h"
 #include "weapon/beam.h"
 #include "multithread/multithread.h"
+#include "io/timer.h"
+#include "cfile/cfile.h"
 
 //tehe. Declare the main event
 script_state Script_system("FS2_Open Scripting");
@@ -203,23 +206,271 @@ void script_init()
 	parse_modular_table(NOX("*-sct.tbm"), script_parse_table);
 	mprintf(("SCRIPTING: Inititialization complete.\n"));
 }
-/*
-//WMC - Doesn't work as debug console interferes with any non-alphabetic chars.
-DCF(script, "Evaluates a line of scripting")
+//*************************Scripting profiler*************************
+//Times every chunk run through RunBytecodeSub, and the condition checks
+//and hook runs of every action. Optionally samples the running Lua code
+//with a count hook so time can be pinned on a source line.
+struct script_profile_entry
+{
+	SCP_string name;
+	int calls;
+	longlong total_us;
+	int max_us;
+
+	script_profile_entry() : calls(0), total_us(0), max_us(0) {}
+
+	void Add(int us)
+	{
+		calls++;
+		total_us += us;
+		if(us > max_us)
+			max_us = us;
+	}
+};
+
+static bool Script_profile_enabled = false;
+static int Script_profile_sample_rate = 0;			//Lua instructions between samples, 0 for off
+static SCP_map<int, script_profile_entry> Script_profile_chunks;	//Keyed by chunk registry index
+static SCP_map<int, SCP_string> Script_profile_chunk_names;
+static script_profile_entry Script_profile_conditions[CHA_LAST+1];
+static script_profile_entry Script_profile_hooks[CHA_LAST+1];
+static SCP_map<SCP_string, int> Script_profile_samples;	//Keyed by source:line
+static int Script_profile_total_samples = 0;
+
+static void script_profile_name_chunk(int index, const char *name)
+{
+	if(index >= 0 && name != NULL)
+		Script_profile_chunk_names[index] = name;
+}
+
+static const char *script_profile_action_name(int action)
+{
+	for(int i = 0; i < Num_script_actions; i++)
+	{
+		if(Script_actions[i].def == action)
+			return Script_actions[i].name;
+	}
+
+	return "Unknown";
+}
+
+static void script_profile_add_chunk(int index, int us)
+{
+	script_profile_entry &spe = Script_profile_chunks[index];
+	if(spe.calls == 0)
+	{
+		SCP_map<int, SCP_string>::iterator it = Script_profile_chunk_names.find(index);
+		if(it != Script_profile_chunk_names.end())
+			spe.name = it->second;
+		else
+		{
+			char buf[32];
+			sprintf(buf, "chunk %d", index);
+			spe.name = buf;
+		}
+	}
+	spe.Add(us);
+}
+
+static void script_profile_sample(lua_State *L, lua_Debug *ar)
+{
+	if(!lua_getinfo(L, "Sl", ar))
+		return;
+
+	char buf[LUA_IDSIZE + 16];
+	sprintf(buf, "%s:%d", ar->short_src, ar->currentline);
+	Script_profile_samples[buf]++;
+	Script_profile_total_samples++;
+}
+
+static void script_profile_set_sampling(int rate)
+{
+	Script_profile_sample_rate = rate;
+
+	lua_State *L = Script_system.GetLuaSession();
+	if(L == NULL)
+		return;
+
+	if(rate > 0)
+		lua_sethook(L, script_profile_sample, LUA_MASKCOUNT, rate);
+	else
+		lua_sethook(L, NULL, 0, 0);
+}
+
+static void script_profile_reset()
+{
+	Script_profile_chunks.clear();
+	for(int i = 0; i <= CHA_LAST; i++)
+	{
+		Script_profile_conditions[i] = script_profile_entry();
+		Script_profile_hooks[i] = script_profile_entry();
+	}
+	Script_profile_samples.clear();
+	Script_profile_total_samples = 0;
+}
+
+//Sorted copies of the results, most expensive first
+static bool script_profile_entry_compare(const script_profile_entry *a, const script_profile_entry *b)
+{
+	return a->total_us > b->total_us;
+}
+
+static bool script_profile_sample_compare(const std::pair<SCP_string, int> &a, const std::pair<SCP_string, int> &b)
+{
+	return a.second > b.second;
+}
+
+static void script_profile_collect(SCP_vector<script_profile_entry*> &chunks, SCP_vector<std::pair<SCP_string, int> > &samples)
+{
+	for(SCP_map<int, script_profile_entry>::iterator it = Script_profile_chunks.begin(); it != Script_profile_chunks.end(); ++it)
+		chunks.push_back(&it->second);
+	std::sort(chunks.begin(), chunks.end(), script_profile_entry_compare);
+
+	samples.assign(Script_profile_samples.begin(), Script_profile_samples.end());
+	std::sort(samples.begin(), samples.end(), script_profile_sample_compare);
+}
+
+static void script_profile_print_entry(const char *type, const char *name, script_profile_entry *spe)
+{
+	dc_printf("%-5s %8d %10.2f %8.1f %8d  %s\n", type, spe->calls, (double)spe->total_us / 1000.0,
+		(double)spe->total_us / spe->calls, spe->max_us, name);
+}
+
+static void script_profile_print(int max_lines)
+{
+	SCP_vector<script_profile_entry*> chunks;
+	SCP_vector<std::pair<SCP_string, int> > samples;
+	script_profile_collect(chunks, samples);
+
+	dc_printf("%-5s %8s %10s %8s %8s  %s\n", "Type", "Calls", "Total ms", "Avg us", "Max us", "Name");
+	for(int i = 0; i <= CHA_LAST; i++)
+	{
+		if(Script_profile_hooks[i].calls > 0)
+			script_profile_print_entry("hook", script_profile_action_name(i), &Script_profile_hooks[i]);
+		if(Script_profile_conditions[i].calls > 0)
+			script_profile_print_entry("cond", script_profile_action_name(i), &Script_profile_conditions[i]);
+	}
+	for(int i = 0; i < (int)chunks.size() && i < max_lines; i++)
+		script_profile_print_entry("chunk", chunks[i]->name.c_str(), chunks[i]);
+
+	if(Script_profile_total_samples > 0)
+	{
+		dc_printf("\n%8s %6s  %s\n", "Samples", "%", "Source");
+		for(int i = 0; i < (int)samples.size() && i < max_lines; i++)
+			dc_printf("%8d %6.2f  %s\n", samples[i].second, 100.0f * samples[i].second / Script_profile_total_samples, samples[i].first.c_str());
+	}
+}
+
+static void script_profile_write_entry(CFILE *cfp, const char *type, const char *name, script_profile_entry *spe)
+{
+	char buf[512];
+	sprintf(buf, "%s,\"%s\",%d,%.3f,%.1f,%d\n", type, name, spe->calls, (double)spe->total_us / 1000.0,
+		(double)spe->total_us / spe->calls, spe->max_us);
+	cfputs(buf, cfp);
+}
+
+static bool script_profile_dump(const char *filename)
+{
+	CFILE *cfp = cfopen((char*)filename, "wt", CFILE_NORMAL, CF_TYPE_DATA);
+	if(cfp == NULL)
+		return false;
+
+	SCP_vector<script_profile_entry*> chunks;
+	SCP_vector<std::pair<SCP_string, int> > samples;
+	script_profile_collect(chunks, samples);
+
+	cfputs("type,name,calls,total_ms,avg_us,max_us\n", cfp);
+	for(int i = 0; i <= CHA_LAST; i++)
+	{
+		if(Script_profile_hooks[i].calls > 0)
+			script_profile_write_entry(cfp, "hook", script_profile_action_name(i), &Script_profile_hooks[i]);
+		if(Script_profile_conditions[i].calls > 0)
+			script_profile_write_entry(cfp, "cond", script_profile_action_name(i), &Script_profile_conditions[i]);
+	}
+	for(size_t i = 0; i < chunks.size(); i++)
+		script_profile_write_entry(cfp, "chunk", chunks[i]->name.c_str(), chunks[i]);
+
+	char buf[512];
+	for(size_t i = 0; i < samples.size(); i++)
+	{
+		sprintf(buf, "sample,\"%s\",%d,,,\n", samples[i].first.c_str(), samples[i].second);
+		cfputs(buf, cfp);
+	}
+
+	cfclose(cfp);
+	return true;
+}
+
+//WMC - Evaluating script lines doesn't work as debug console interferes
+//with any non-alphabetic chars, so this only drives the profiler.
+DCF(script, "Controls the scripting profiler")
 {
 	if(Dc_command)
 	{
 		dc_get_arg(ARG_STRING);
-		Script_system.EvalString(Dc_arg);
+		if(!strcmp(Dc_arg, "profile"))
+		{
+			dc_get_arg(ARG_TRUE | ARG_FALSE | ARG_NONE);
+			if(Dc_arg_type & ARG_TRUE)
+				Script_profile_enabled = true;
+			else if(Dc_arg_type & ARG_FALSE)
+				Script_profile_enabled = false;
+			else
+				Script_profile_enabled = !Script_profile_enabled;
+			dc_printf("Script profiling is %s\n", Script_profile_enabled ? "on" : "off");
+		}
+		else if(!strcmp(Dc_arg, "sample"))
+		{
+			dc_get_arg(ARG_INT | ARG_FALSE);
+			if(Dc_arg_type & ARG_INT)
+				script_profile_set_sampling(MAX(Dc_arg_int, 0));
+			else
+				script_profile_set_sampling(0);
+		}
+		else if(!strcmp(Dc_arg, "reset"))
+		{
+			script_profile_reset();
+		}
+		else if(!strcmp(Dc_arg, "show"))
+		{
+			dc_get_arg(ARG_INT | ARG_NONE);
+			script_profile_print((Dc_arg_type & ARG_INT) ? Dc_arg_int : 20);
+		}
+		else if(!strcmp(Dc_arg, "dump"))
+		{
+			dc_get_arg(ARG_STRING | ARG_NONE);
+			const char *filename = (Dc_arg_type & ARG_STRING) ? Dc_arg : "script_profile.csv";
+			if(script_profile_dump(filename))
+				dc_printf("Script profile written to %s\n", filename);
+			else
+				dc_printf("Could not open %s for writing\n", filename);
+		}
+		else
+		{
+			Dc_help = 1;
+		}
 	}
 
 	if(Dc_help)
 	{
-		dc_printf("Usage: script <script\n");
-		dc_printf("<script> --  Scripting to evaluate.\n");
+		dc_printf("Usage: script keyword\nWhere keyword can be in the following forms:\n");
+		dc_printf("script profile [on|off]  Times script hooks, conditions and chunks.\n");
+		dc_printf("script sample <n|off>    Samples the running Lua line every n instructions.\n");
+		dc_printf("script reset             Clears collected timings and samples.\n");
+		dc_printf("script show [n]          Prints the totals and the n most expensive chunks and lines.\n");
+		dc_printf("script dump [file]       Writes everything to a CSV file in data/.\n");
+		Dc_status = 0;
+	}
+
+	if(Dc_status)
+	{
+		dc_printf("Script profiling is %s, ", Script_profile_enabled ? "on" : "off");
+		if(Script_profile_sample_rate > 0)
+			dc_printf("sampling every %d instructions (%d samples)\n", Script_profile_sample_rate, Script_profile_total_samples);
+		else
+			dc_printf("sampling is off\n");
 	}
 }
-*/
 
 //*************************CLASS: ConditionedScript*************************
 extern char Game_current_mission_filename[];
@@ -247,6 +498,107 @@ bool ConditionedHook::AddAction(script_action *sa)
 	return true;
 }
 
+bool ConditionedHook::HasAction(int action)
+{
+	for(SCP_vector<script_action>::iterator sap = Actions.begin(); sap != Actions.end(); ++sap)
+	{
+		if(sap->action_type == action)
+			return true;
+	}
+
+	return false;
+}
+
+//Mission and campaign conditions can only change when the mission or campaign does, so their
+//results are kept until the filenames change
+static int Script_condition_epoch = 0;
+static char Script_condition_mission[sizeof(Mission_filename)] = "";
+static char Script_condition_campaign[MAX_FILENAME_LEN] = "";
+
+static void script_update_condition_epoch()
+{
+	if(strcmp(Script_condition_mission, Mission_filename) || strcmp(Script_condition_campaign, Campaign.filename))
+	{
+		strcpy_s(Script_condition_mission, Mission_filename);
+		strcpy_s(Script_condition_campaign, Campaign.filename);
+		Script_condition_epoch++;
+	}
+}
+
+//Look up the name of a condition as an index, the first time it is checked
+static int script_condition_resolve(script_condition *scp)
+{
+	int i;
+
+	if(scp->resolved != CONDITION_UNRESOLVED)
+		return scp->resolved;
+
+	scp->resolved = -1;
+	switch(scp->condition_type)
+	{
+		case CHC_STATE:
+			for(i = 0; i < GS_NUM_STATES; i++)
+			{
+				if(!stricmp(GS_state_text[i], scp->data.name))
+				{
+					scp->resolved = i;
+					break;
+				}
+			}
+			break;
+		case CHC_SHIPTYPE:
+			scp->resolved = ship_type_name_lookup(scp->data.name);
+			break;
+		case CHC_SHIPCLASS:
+			scp->resolved = ship_info_lookup(scp->data.name);
+			break;
+		case CHC_WEAPONCLASS:
+			scp->resolved = weapon_info_lookup(scp->data.name);
+			break;
+		case CHC_OBJECTTYPE:
+			for(i = 0; i < MAX_OBJECT_TYPES; i++)
+			{
+				if(!stricmp(Object_type_names[i], scp->data.name))
+				{
+					scp->resolved = i;
+					break;
+				}
+			}
+			break;
+		case CHC_VERSION:
+			{
+				// Goober5000: I'm going to assume scripting doesn't care about SVN revision
+				char buf[32];
+				sprintf(buf, "%i.%i.%i", FS_VERSION_MAJOR, FS_VERSION_MINOR, FS_VERSION_BUILD);
+				scp->resolved = stricmp(buf, scp->data.name) ? 0 : 1;
+
+				//In case some people are lazy and say "3.7" instead of "3.7.0" or something
+				if(!scp->resolved && FS_VERSION_BUILD == 0)
+				{
+					sprintf(buf, "%i.%i", FS_VERSION_MAJOR, FS_VERSION_MINOR);
+					scp->resolved = stricmp(buf, scp->data.name) ? 0 : 1;
+				}
+				break;
+			}
+		case CHC_APPLICATION:
+			if(Fred_running)
+				scp->resolved = (stricmp("FRED2_Open", scp->data.name) && stricmp("FRED2Open", scp->data.name) && stricmp("FRED 2", scp->data.name) && stricmp("FRED", scp->data.name)) ? 0 : 1;
+			else
+				scp->resolved = (stricmp("FS2_Open", scp->data.name) && stricmp("FS2Open", scp->data.name) && stricmp("Freespace 2", scp->data.name) && stricmp("Freespace", scp->data.name)) ? 0 : 1;
+			break;
+		default:
+			break;
+	}
+
+	return scp->resolved;
+}
+
+//True if the weapon in this bank is the one the condition resolved to
+static inline bool script_weapon_matches(int weapon_idx, int resolved)
+{
+	return (resolved >= 0) && (weapon_idx == resolved);
+}
+
 bool ConditionedHook::ConditionsValid(int action, object *objp, int more_data)
 {
 	uint i;
@@ -257,12 +609,17 @@ bool ConditionedHook::ConditionsValid(int action, object *objp, int more_data)
 	for(i = 0; i < MAX_HOOK_CONDITIONS; i++)
 	{
 		scp = &Conditions[i];
+
+		//Conditions are added in order, so the first empty one ends the list
+		if(scp->condition_type == CHC_NONE)
+			break;
+
 		switch(scp->condition_type)
 		{
 			case CHC_STATE:
 				if(gameseq_get_depth() < 0)
 					return false;
-				if(stricmp(GS_state_text[gameseq_get_state(0)], scp->data.name))
+				if(gameseq_get_state(0) != script_condition_resolve(scp))
 					return false;
 				break;
 			case CHC_SHIPTYPE:
@@ -271,12 +628,13 @@ bool ConditionedHook::ConditionsValid(int action, object *objp, int more_data)
 				sip = &Ship_info[Ships[objp->instance].ship_info_index];
 				if(sip->class_type < 0)
 					return false;
-				if(stricmp(Ship_types[sip->class_type].name, scp->data.name))
+				if(sip->class_type != script_condition_resolve(scp))
 					return false;
+				break;
 			case CHC_SHIPCLASS:
 				if(objp == NULL || objp->type != OBJ_SHIP)
 					return false;
-				if(stricmp(Ship_info[Ships[objp->instance].ship_info_index].name, scp->data.name))
+				if(Ships[objp->instance].ship_info_index != script_condition_resolve(scp))
 					return false;
 				break;
 			case CHC_SHIP:
@@ -287,40 +645,48 @@ bool ConditionedHook::ConditionsValid(int action, object *objp, int more_data)
 				break;
 			case CHC_MISSION:
 				{
-					//WMC - Get mission filename with Mission_filename
-					//I don't use Game_current_mission_filename, because
-					//Mission_filename is valid in both fs2_open and FRED
-					size_t len = strlen(Mission_filename);
-					if(!len)
-						return false;
-					if(len > 4 && !stricmp(&Mission_filename[len-4], ".fs2"))
-						len -= 4;
-					if(strnicmp(scp->data.name, Mission_filename, len))
+					if(scp->cache_key != Script_condition_epoch)
+					{
+						//WMC - Get mission filename with Mission_filename
+						//I don't use Game_current_mission_filename, because
+						//Mission_filename is valid in both fs2_open and FRED
+						size_t len = strlen(Mission_filename);
+						if(len > 4 && !stricmp(&Mission_filename[len-4], ".fs2"))
+							len -= 4;
+						scp->cache_key = Script_condition_epoch;
+						scp->cache_result = len && !strnicmp(scp->data.name, Mission_filename, len);
+					}
+					if(!scp->cache_result)
 						return false;
 					break;
 				}
 			case CHC_CAMPAIGN:
 				{
-					size_t len = strlen(Campaign.filename);
-					if(!len)
-						return false;
-					if(len > 4 && !stricmp(&Mission_filename[len-4], ".fc2"))
-						len -= 4;
-					if(strnicmp(scp->data.name, Mission_filename, len))
+					if(scp->cache_key != Script_condition_epoch)
+					{
+						size_t len = strlen(Campaign.filename);
+						if(len > 4 && !stricmp(&Mission_filename[len-4], ".fc2"))
+							len -= 4;
+						scp->cache_key = Script_condition_epoch;
+						scp->cache_result = len && !strnicmp(scp->data.name, Mission_filename, len);
+					}
+					if(!scp->cache_result)
 						return false;
 					break;
 				}
 			case CHC_WEAPONCLASS:
 				{
+					int weapon_idx = script_condition_resolve(scp);
+
 					if (action == CHA_COLLIDEWEAPON) {
-						if (stricmp(Weapon_info[more_data].name, scp->data.name) != 0)
+						if (!script_weapon_matches(more_data, weapon_idx))
 							return false;
 					} else if (!(action == CHA_ONWPSELECTED || action == CHA_ONWPDESELECTED || action == CHA_ONWPEQUIPPED || action == CHA_ONWPFIRED || action == CHA_ONTURRETFIRED )) {
 						if(objp == NULL || (objp->type != OBJ_WEAPON && objp->type != OBJ_BEAM))
 							return false;
-						else if (( objp->type == OBJ_WEAPON) && (stricmp(Weapon_info[Weapons[objp->instance].weapon_info_index].name, scp->data.name) != 0 ))
+						else if (( objp->type == OBJ_WEAPON) && !script_weapon_matches(Weapons[objp->instance].weapon_info_index, weapon_idx))
 							return false;
-						else if (( objp->type == OBJ_BEAM) && (stricmp(Weapon_info[Beams[objp->instance].weapon_info_index].name, scp->data.name) != 0 ))
+						else if (( objp->type == OBJ_BEAM) && !script_weapon_matches(Beams[objp->instance].weapon_info_index, weapon_idx))
 							return false;
 					} else if(objp == NULL || objp->type != OBJ_SHIP) {
 						return false;
@@ -328,26 +694,27 @@ bool ConditionedHook::ConditionsValid(int action, object *objp, int more_data)
 
 						// Okay, if we're still here, then objp is both valid and a ship
 						ship* shipp = &Ships[objp->instance];
+						ship_weapon *swp = &shipp->weapons;
 						bool primary = false, secondary = false, prev_primary = false, prev_secondary = false;
 						switch (action) {
 							case CHA_ONWPSELECTED:
-								primary = stricmp(Weapon_info[shipp->weapons.primary_bank_weapons[shipp->weapons.current_primary_bank]].name, scp->data.name) == 0;
-								secondary = stricmp(Weapon_info[shipp->weapons.secondary_bank_weapons[shipp->weapons.current_secondary_bank]].name, scp->data.name) == 0;
+								primary = script_weapon_matches(swp->primary_bank_weapons[swp->current_primary_bank], weapon_idx);
+								secondary = script_weapon_matches(swp->secondary_bank_weapons[swp->current_secondary_bank], weapon_idx);
 								
 								if (!(primary || secondary))
 									return false;
 
-								if ((shipp->flags & SF_PRIMARY_LINKED) && primary && (Weapon_info[shipp->weapons.primary_bank_weapons[shipp->weapons.current_primary_bank]].wi_flags3 & WIF3_NOLINK))
+								if ((shipp->flags & SF_PRIMARY_LINKED) && primary && (Weapon_info[swp->primary_bank_weapons[swp->current_primary_bank]].wi_flags3 & WIF3_NOLINK))
 									return false;
 								
 								break;
 							case CHA_ONWPDESELECTED:
-								primary = stricmp(Weapon_info[shipp->weapons.primary_bank_weapons[shipp->weapons.current_primary_bank]].name, scp->data.name) == 0;
-								prev_primary = stricmp(Weapon_info[shipp->weapons.primary_bank_weapons[shipp->weapons.previous_primary_bank]].name, scp->data.name) == 0;
-								secondary = stricmp(Weapon_info[shipp->weapons.secondary_bank_weapons[shipp->weapons.current_secondary_bank]].name, scp->data.name) == 0;
-								prev_secondary = stricmp(Weapon_info[shipp->weapons.secondary_bank_weapons[shipp->weapons.previous_secondary_bank]].name, scp->data.name) == 0;
+								primary = script_weapon_matches(swp->primary_bank_weapons[swp->current_primary_bank], weapon_idx);
+								prev_primary = script_weapon_matches(swp->primary_bank_weapons[swp->previous_primary_bank], weapon_idx);
+								secondary = script_weapon_matches(swp->secondary_bank_weapons[swp->current_secondary_bank], weapon_idx);
+								prev_secondary = script_weapon_matches(swp->secondary_bank_weapons[swp->previous_secondary_bank], weapon_idx);
 
-								if ((shipp->flags & SF_PRIMARY_LINKED) && prev_primary && (Weapon_info[shipp->weapons.primary_bank_weapons[shipp->weapons.previous_primary_bank]].wi_flags3 & WIF3_NOLINK))
+								if ((shipp->flags & SF_PRIMARY_LINKED) && prev_primary && (Weapon_info[swp->primary_bank_weapons[swp->previous_primary_bank]].wi_flags3 & WIF3_NOLINK))
 									return true;
 
 								if ( !prev_secondary && ! secondary && !prev_primary && !primary )
@@ -369,21 +736,17 @@ bool ConditionedHook::ConditionsValid(int action, object *objp, int more_data)
 							case CHA_ONWPEQUIPPED: {
 								bool equipped = false;
 								for(int j = 0; j < MAX_SHIP_PRIMARY_BANKS; j++) {
-									if (!equipped && (shipp->weapons.primary_bank_weapons[j] >= 0) && (shipp->weapons.primary_bank_weapons[j] < MAX_WEAPON_TYPES) ) {
-										if ( !stricmp(Weapon_info[shipp->weapons.primary_bank_weapons[j]].name, scp->data.name) ) {
-											equipped = true;
-											break;
-										}
+									if (script_weapon_matches(swp->primary_bank_weapons[j], weapon_idx)) {
+										equipped = true;
+										break;
 									}
 								}
 							
 								if (!equipped) {
 									for(int j = 0; j < MAX_SHIP_SECONDARY_BANKS; j++) {
-										if (!equipped && (shipp->weapons.secondary_bank_weapons[j] >= 0) && (shipp->weapons.secondary_bank_weapons[j] < MAX_WEAPON_TYPES) ) {
-											if ( !stricmp(Weapon_info[shipp->weapons.secondary_bank_weapons[j]].name, scp->data.name) ) {
-												equipped = true;
-												break;
-											}
+										if (script_weapon_matches(swp->secondary_bank_weapons[j], weapon_idx)) {
+											equipped = true;
+											break;
 										}
 									}
 								}
@@ -395,14 +758,14 @@ bool ConditionedHook::ConditionsValid(int action, object *objp, int more_data)
 							}
 							case CHA_ONWPFIRED: {
 								if (more_data == 1) {
-									primary = stricmp(Weapon_info[shipp->weapons.primary_bank_weapons[shipp->weapons.current_primary_bank]].name, scp->data.name) == 0;
+									primary = script_weapon_matches(swp->primary_bank_weapons[swp->current_primary_bank], weapon_idx);
 									secondary = false;
 								} else {
 									primary = false;
-									secondary = stricmp(Weapon_info[shipp->weapons.secondary_bank_weapons[shipp->weapons.current_secondary_bank]].name, scp->data.name) == 0;
+									secondary = script_weapon_matches(swp->secondary_bank_weapons[swp->current_secondary_bank], weapon_idx);
 								}
 
-								if ((shipp->flags & SF_PRIMARY_LINKED) && primary && (Weapon_info[shipp->weapons.primary_bank_weapons[shipp->weapons.current_primary_bank]].wi_flags3 & WIF3_NOLINK))
+								if ((shipp->flags & SF_PRIMARY_LINKED) && primary && (Weapon_info[swp->primary_bank_weapons[swp->current_primary_bank]].wi_flags3 & WIF3_NOLINK))
 								 	return false;
 
 								return more_data == 1 ? primary : secondary;
@@ -410,17 +773,17 @@ bool ConditionedHook::ConditionsValid(int action, object *objp, int more_data)
 								break;
 							}
 							case CHA_ONTURRETFIRED: {
-								if (! (stricmp(Weapon_info[shipp->last_fired_turret->last_fired_weapon_info_index].name, scp->data.name) == 0))
+								if (!script_weapon_matches(shipp->last_fired_turret->last_fired_weapon_info_index, weapon_idx))
 									return false;
 								break;
 							}
 							case CHA_PRIMARYFIRE: {
-								if (stricmp(Weapon_info[shipp->weapons.primary_bank_weapons[shipp->weapons.current_primary_bank]].name, scp->data.name))
+								if (!script_weapon_matches(swp->primary_bank_weapons[swp->current_primary_bank], weapon_idx))
 									return false;
 								break;
 							}
 							case CHA_SECONDARYFIRE: {
-								if (stricmp(Weapon_info[shipp->weapons.secondary_bank_weapons[shipp->weapons.current_secondary_bank]].name, scp->data.name))
+								if (!script_weapon_matches(swp->secondary_bank_weapons[swp->current_secondary_bank], weapon_idx))
 									return false;
 								break;
 							}
@@ -432,7 +795,7 @@ bool ConditionedHook::ConditionsValid(int action, object *objp, int more_data)
 			case CHC_OBJECTTYPE:
 				if(objp == NULL)
 					return false;
-				if(stricmp(Object_type_names[objp->type], scp->data.name))
+				if(objp->type != script_condition_resolve(scp))
 					return false;
 				break;
 			case CHC_KEYPRESS:
@@ -459,39 +822,10 @@ bool ConditionedHook::ConditionsValid(int action, object *objp, int more_data)
 					break;
 				}
 			case CHC_VERSION:
-				{
-					// Goober5000: I'm going to assume scripting doesn't care about SVN revision
-					char buf[32];
-					sprintf(buf, "%i.%i.%i", FS_VERSION_MAJOR, FS_VERSION_MINOR, FS_VERSION_BUILD);
-					if(stricmp(buf, scp->data.name))
-					{
-						//In case some people are lazy and say "3.7" instead of "3.7.0" or something
-						if(FS_VERSION_BUILD == 0)
-						{
-							sprintf(buf, "%i.%i", FS_VERSION_MAJOR, FS_VERSION_MINOR);
-							if(stricmp(buf, scp->data.name))
-								return false;
-						}
-						else
-						{
-							return false;
-						}
-					}
-					break;
-				}
 			case CHC_APPLICATION:
-				{
-					if(Fred_running)
-					{
-						if(stricmp("FRED2_Open", scp->data.name) && stricmp("FRED2Open", scp->data.name) && stricmp("FRED 2", scp->data.name) && stricmp("FRED", scp->data.name))
-							return false;
-					}
-					else
-					{
-						if(stricmp("FS2_Open", scp->data.name) && stricmp("FS2Open", scp->data.name) && stricmp("Freespace 2", scp->data.name) && stricmp("Freespace", scp->data.name))
-							return false;
-					}
-				}
+				if(!script_condition_resolve(scp))
+					return false;
+				break;
 			default:
 				break;
 		}
@@ -577,6 +911,9 @@ void script_state::SetHookObjects(int num, ...)
 //for the hook library.
 //Call CloseHookVarTable() only if OpenHookVarTable()
 //returns true. (see below)
+//The table is looked up once and then kept in the registry,
+//so hooks that set several variables per frame only pay for
+//a single rawgeti.
 static int ohvt_poststack = 0;		//Items on the stack prior to OHVT
 static int ohvt_isopen = 0;			//Items OHVT puts on the stack
 bool script_state::OpenHookVarTable()
@@ -585,34 +922,41 @@ bool script_state::OpenHookVarTable()
 	if(ohvt_isopen)
 		Error(LOCATION, "OpenHookVarTable was called twice with no call to CloseHookVarTable - missing call ahoy!");
 
-	lua_pushstring(LuaState, "hv");
-	lua_gettable(LuaState, LUA_GLOBALSINDEX);
-	int sv_ldx = lua_gettop(LuaState);
-	if(lua_isuserdata(LuaState, sv_ldx))
+	if(HookVarTableRef == LUA_NOREF)
 	{
-		//Get ScriptVar metatable
-		lua_getmetatable(LuaState, sv_ldx);
-		int mtb_ldx = lua_gettop(LuaState);
-		if(lua_istable(LuaState, mtb_ldx))
+		lua_pushstring(LuaState, "hv");
+		lua_gettable(LuaState, LUA_GLOBALSINDEX);
+		int sv_ldx = lua_gettop(LuaState);
+		if(lua_isuserdata(LuaState, sv_ldx))
 		{
-			//Get ScriptVar/metatable/__ademembers
-			lua_pushstring(LuaState, "__ademembers");
-			lua_rawget(LuaState, mtb_ldx);
-			int amt_ldx = lua_gettop(LuaState);
-			if(lua_istable(LuaState, amt_ldx))
+			//Get ScriptVar metatable
+			lua_getmetatable(LuaState, sv_ldx);
+			int mtb_ldx = lua_gettop(LuaState);
+			if(lua_istable(LuaState, mtb_ldx))
 			{
-				ohvt_isopen = 3;
-				ohvt_poststack = amt_ldx;
-				return true;
+				//Get ScriptVar/metatable/__ademembers
+				lua_pushstring(LuaState, "__ademembers");
+				lua_rawget(LuaState, mtb_ldx);
+				if(lua_istable(LuaState, -1))
+					HookVarTableRef = luaL_ref(LuaState, LUA_REGISTRYINDEX);
+				else
+					lua_pop(LuaState, 1);	//amt
 			}
-			lua_pop(LuaState, 1);	//amt
+			lua_pop(LuaState, 1);	//metatable
+		}
+		lua_pop(LuaState, 1);	//Library
+
+		if(HookVarTableRef == LUA_NOREF)
+		{
+			HOOK_UNLOCK;
+			return false;
 		}
-		lua_pop(LuaState, 1);	//metatable
 	}
-	lua_pop(LuaState, 1);	//Library
-	
-	HOOK_UNLOCK;
-	return false;
+
+	lua_rawgeti(LuaState, LUA_REGISTRYINDEX, HookVarTableRef);
+	ohvt_isopen = 1;
+	ohvt_poststack = lua_gettop(LuaState);
+	return true;
 }
 
 //Call when you are done with CloseHookVarTable,
@@ -866,7 +1210,12 @@ int script_state::RunBytecodeSub(int in_lang, int in_idx, char format, void *dat
 
 			if(lua_isfunction(GetLuaSession(), hook_ldx))
 			{
-				if(lua_pcall(GetLuaSession(), 0, format!='\0' ? 1 : 0, err_ldx) != 0)
+				int start_us = Script_profile_enabled ? timer_get_microseconds() : 0;
+				int rval = lua_pcall(GetLuaSession(), 0, format!='\0' ? 1 : 0, err_ldx);
+				if(Script_profile_enabled)
+					script_profile_add_chunk(in_idx, timer_get_microseconds() - start_us);
+
+				if(rval != 0)
 				{
 					//WMC - Pop all extra stuff from ze stack.
 					args_start = lua_gettop(GetLuaSession()) - args_start;
@@ -914,9 +1263,29 @@ int script_state::RunBytecode(script_hook &hd, char format, void *data)
 int script_state::RunCondition(int action, char format, void *data, object *objp, int more_data)
 {
 	int num = 0;
-	for(SCP_vector<ConditionedHook>::iterator chp = ConditionalHooks.begin(); chp != ConditionalHooks.end(); ++chp) 
+
+	if(action < 0 || action > CHA_LAST)
+		return 0;
+
+	//Only hooks that have something to do for this action are looked at
+	script_update_condition_epoch();
+	for(SCP_vector<int>::iterator idx = ActionHooks[action].begin(); idx != ActionHooks[action].end(); ++idx)
 	{
-		if(chp->ConditionsValid(action, objp, more_data))
+		ConditionedHook *chp = &ConditionalHooks[*idx];
+		if(Script_profile_enabled)
+		{
+			int start_us = timer_get_microseconds();
+			bool valid = chp->ConditionsValid(action, objp, more_data);
+			int cond_us = timer_get_microseconds();
+			Script_profile_conditions[action].Add(cond_us - start_us);
+			if(valid)
+			{
+				chp->Run(this, action, format, data);
+				Script_profile_hooks[action].Add(timer_get_microseconds() - cond_us);
+				num++;
+			}
+		}
+		else if(chp->ConditionsValid(action, objp, more_data))
 		{
 			chp->Run(this, action, format, data);
 			num++;
@@ -927,9 +1296,13 @@ int script_state::RunCondition(int action, char format, void *data, object *objp
 
 bool script_state::IsConditionOverride(int action, object *objp)
 {
-	//bool b = false;
-	for(SCP_vector<ConditionedHook>::iterator chp = ConditionalHooks.begin(); chp != ConditionalHooks.end(); ++chp)
+	if(action < 0 || action > CHA_LAST)
+		return false;
+
+	script_update_condition_epoch();
+	for(SCP_vector<int>::iterator idx = ActionHooks[action].begin(); idx != ActionHooks[action].end(); ++idx)
 	{
+		ConditionedHook *chp = &ConditionalHooks[*idx];
 		if(chp->ConditionsValid(action, objp))
 		{
 			if(chp->IsOverride(this, action))
@@ -951,6 +1324,7 @@ void script_state::Clear()
 
 	//Don't close this yet
 	LuaState = NULL;
+	HookVarTableRef = LUA_NOREF;
 	LuaLibs = NULL;
 }
 
@@ -961,6 +1335,7 @@ script_state::script_state(char *name)
 	Langs = 0;
 
 	LuaState = NULL;
+	HookVarTableRef = LUA_NOREF;
 	LuaLibs = NULL;
 }
 
@@ -987,6 +1362,7 @@ void script_state::SetLuaSession(lua_State *L)
 		lua_close(LuaState);
 	}
 	LuaState = L;
+	HookVarTableRef = LUA_NOREF;
 	if(LuaState != NULL) {
 		Langs |= SC_LUA;
 	}
@@ -1189,6 +1565,7 @@ void script_state::ParseChunkSub(int *out_lang, int *out_index, char* debug_str)
 			{
 				//Stick it in the registry
 				*out_index = luaL_ref(GetLuaSession(), LUA_REGISTRYINDEX);
+				script_profile_name_chunk(*out_index, filename);
 			}
 			else
 			{
@@ -1226,6 +1603,7 @@ void script_state::ParseChunkSub(int *out_lang, int *out_index, char* debug_str)
 		{
 			//Stick it in the registry
 			*out_index = luaL_ref(GetLuaSession(), LUA_REGISTRYINDEX);
+			script_profile_name_chunk(*out_index, debug_str);
 		}
 		else
 		{
@@ -1262,6 +1640,7 @@ void script_state::ParseChunkSub(int *out_lang, int *out_index, char* debug_str)
 		{
 			//Stick it in the registry
 			*out_index = luaL_ref(GetLuaSession(), LUA_REGISTRYINDEX);
+			script_profile_name_chunk(*out_index, debug_str);
 		}
 		else
 		{
@@ -1397,6 +1776,14 @@ bool script_state::ParseCondition(const char *filename)
 		return false;
 	}
 
+	//Index the hook under each of its actions
+	int hook_idx = (int)ConditionalHooks.size() - 1;
+	for(int i = 0; i <= CHA_LAST; i++)
+	{
+		if(chp->HasAction(i))
+			ActionHooks[i].push_back(hook_idx);
+	}
+
 	return true;
 }
 
@@ -74,12 +74,15 @@ struct image_desc
 #define CHA_COLLIDEBEAM		31
 #define CHA_ONACTION		32
 #define CHA_ONACTIONSTOPPED	33
+#define CHA_LAST			CHA_ONACTIONSTOPPED
 
 // management stuff
 void scripting_state_init();
 void scripting_state_close();
 void scripting_state_do_frame(float frametime);
 
+#define CONDITION_UNRESOLVED	-2
+
 class script_condition
 {
 public:
@@ -89,8 +92,16 @@ public:
 		char name[CONDITION_LENGTH];
 	} data;
 
+	//The name looked up once as an index (ship class, weapon class, state...), so checking
+	//the condition is an integer compare. Done lazily since the tables load after scripting.tbl
+	int resolved;
+
+	//Last result for things that only change between missions
+	int cache_key;
+	bool cache_result;
+
 	script_condition()
-		: condition_type(CHC_NONE)
+		: condition_type(CHC_NONE), resolved(CONDITION_UNRESOLVED), cache_key(-1), cache_result(false)
 	{
 		memset(data.name, 0, sizeof(data.name));
 	}
@@ -117,6 +128,7 @@ private:
 public:
 	bool AddCondition(script_condition *sc);
 	bool AddAction(script_action *sa);
+	bool HasAction(int action);
 
 	bool ConditionsValid(int action, class object *objp=NULL, int more_data = 0);
 	bool IsOverride(class script_state *sys, int action);
@@ -131,11 +143,13 @@ private:
 
 	int Langs;
 	struct lua_State *LuaState;
+	int HookVarTableRef;			//Registry ref to the hook variable member table
 	const struct script_lua_lib_list *LuaLibs;
 
 	//Utility variables
 	SCP_vector<image_desc> ScriptImages;
 	SCP_vector<ConditionedHook> ConditionalHooks;
+	SCP_vector<int> ActionHooks[CHA_LAST+1];		//Indexes into ConditionalHooks of the hooks with each action
 
 private:
 
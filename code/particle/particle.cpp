@@ -451,11 +451,12 @@ void particle_render_all()
 		}
 	}
 
-	profile_begin("Batch Render");
+	static int batch_site = profile_site("Batch Render");
+	profile_begin(batch_site);
 	if (render_batch) {
 		batch_render_all(Particle_buffer_object);
 	}
-	profile_end("Batch Render");
+	profile_end(batch_site);
 }
 
 
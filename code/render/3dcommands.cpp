@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) Freespace Open 2026.  All rights reserved.
+ *
+ * All source code herein is the property of Freespace Open. You may not sell
+ * or otherwise commercially exploit the source or things you created based on the
+ * source.
+ *
+*/
+
+
+
+#include "render/3dcommands.h"
+#include "render/3d.h"
+#include "graphics/2d.h"
+#include "bmpman/bmpman.h"
+
+
+void render_command_list::start_instance(vec3d *pos, matrix *orient)
+{
+	render_command cmd;
+
+	cmd.type = CMD_START_INSTANCE;
+	cmd.instance.pos = *pos;
+	cmd.instance.orient = *orient;
+
+	commands.push_back(cmd);
+}
+
+void render_command_list::done_instance()
+{
+	// nothing was drawn in this instance, so forget about it altogether
+	if ( !commands.empty() && (commands.back().type == CMD_START_INSTANCE) ) {
+		commands.pop_back();
+		return;
+	}
+
+	render_command cmd;
+
+	cmd.type = CMD_DONE_INSTANCE;
+
+	commands.push_back(cmd);
+}
+
+void render_command_list::draw_buffer(vertex_buffer *buffer, int texi, uint tmap_flags, int texture, int blend_filter, float alpha, vec3d *scale, int zbuffer_mode)
+{
+	render_command cmd;
+
+	cmd.type = CMD_DRAW_BUFFER;
+	cmd.draw.buffer = buffer;
+	cmd.draw.texi = texi;
+	cmd.draw.tmap_flags = tmap_flags;
+	cmd.draw.texture = texture;
+	cmd.draw.blend_filter = blend_filter;
+	cmd.draw.alpha = alpha;
+	cmd.draw.scale = *scale;
+	cmd.draw.zbuffer_mode = zbuffer_mode;
+	cmd.draw.glow_map = GLOWMAP;
+	cmd.draw.spec_map = SPECMAP;
+	cmd.draw.norm_map = NORMMAP;
+	cmd.draw.height_map = HEIGHTMAP;
+	cmd.draw.misc_map = MISCMAP;
+
+	commands.push_back(cmd);
+}
+
+void render_command_list::submit()
+{
+	SCP_vector<render_command>::iterator cmd;
+
+	for (cmd = commands.begin(); cmd != commands.end(); ++cmd) {
+		switch (cmd->type) {
+			case CMD_START_INSTANCE:
+				g3_start_instance_matrix(&cmd->instance.pos, &cmd->instance.orient, true);
+				break;
+
+			case CMD_DONE_INSTANCE:
+				g3_done_instance(true);
+				break;
+
+			case CMD_DRAW_BUFFER: {
+				GLOWMAP = cmd->draw.glow_map;
+				SPECMAP = cmd->draw.spec_map;
+				NORMMAP = cmd->draw.norm_map;
+				HEIGHTMAP = cmd->draw.height_map;
+				MISCMAP = cmd->draw.misc_map;
+
+				gr_push_scale_matrix(&cmd->draw.scale);
+				gr_set_bitmap(cmd->draw.texture, cmd->draw.blend_filter, GR_BITBLT_MODE_NORMAL, cmd->draw.alpha);
+
+				int zbuff = gr_zbuffer_set(cmd->draw.zbuffer_mode);
+
+				gr_render_buffer(0, cmd->draw.buffer, cmd->draw.texi, cmd->draw.tmap_flags);
+
+				gr_zbuffer_set(zbuff);
+				gr_pop_scale_matrix();
+
+				GLOWMAP = -1;
+				SPECMAP = -1;
+				NORMMAP = -1;
+				HEIGHTMAP = -1;
+				MISCMAP = -1;
+				break;
+			}
+
+			default:
+				Int3();
+				break;
+		}
+	}
+
+	commands.clear();
+}
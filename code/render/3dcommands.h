@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) Freespace Open 2026.  All rights reserved.
+ *
+ * All source code herein is the property of Freespace Open. You may not sell
+ * or otherwise commercially exploit the source or things you created based on the
+ * source.
+ *
+*/
+
+
+
+#ifndef _3DCOMMANDS_H
+#define _3DCOMMANDS_H
+
+#include "globalincs/pstypes.h"
+
+class vertex_buffer;
+
+// A list of 3D render calls which are recorded now and handed to the gr_* layer later by submit().
+//
+// Instance matrices are only pushed when the list is submitted, and an instance that is closed with
+// nothing drawn inside it is dropped on the spot, so a whole submodel hierarchy can be recorded
+// without paying for the parts of it that turn out to be empty.
+class render_command_list
+{
+public:
+	void start_instance(vec3d *pos, matrix *orient);
+	void done_instance();
+
+	// draws a vertex buffer with the texture maps (GLOWMAP, SPECMAP, ...) that are set when it is recorded
+	void draw_buffer(vertex_buffer *buffer, int texi, uint tmap_flags, int texture, int blend_filter, float alpha, vec3d *scale, int zbuffer_mode);
+
+	// issues everything that was recorded, in order, and empties the list
+	void submit();
+
+	void clear() { commands.clear(); }
+	bool empty() const { return commands.empty(); }
+
+private:
+	enum { CMD_START_INSTANCE, CMD_DONE_INSTANCE, CMD_DRAW_BUFFER };
+
+	typedef struct render_command {
+		int type;
+
+		union {
+			struct {
+				vec3d pos;
+				matrix orient;
+			} instance;
+
+			struct {
+				vertex_buffer *buffer;
+				int texi;
+				uint tmap_flags;
+				int texture;
+				int blend_filter;
+				float alpha;
+				vec3d scale;
+				int zbuffer_mode;
+				int glow_map;
+				int spec_map;
+				int norm_map;
+				int height_map;
+				int misc_map;
+			} draw;
+		};
+	} render_command;
+
+	SCP_vector<render_command> commands;
+};
+
+#endif // _3DCOMMANDS_H
@@ -775,8 +775,10 @@ MONITOR(NumShieldHits)
 void add_shield_point(int objnum, int tri_num, vec3d *hit_pos)
 {
 	SHIP_LOCK
-	if (Num_shield_points >= MAX_SHIELD_POINTS)
+	if (Num_shield_points >= MAX_SHIELD_POINTS) {
+		SHIP_UNLOCK
 		return;
+	}
 
 	Verify(objnum < MAX_OBJECTS);
 
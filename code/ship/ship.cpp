@@ -14,6 +14,7 @@
 
 #include "globalincs/def_files.h"
 #include "globalincs/alphacolors.h"
+#include "globalincs/name_index.h"
 #include "ship/ship.h"
 #include "object/object.h"
 #include "weapon/weapon.h"
@@ -81,6 +82,7 @@
 #include "model/model.h"
 #include "mod_table/mod_table.h"
 #include "osapi/osapi.h"
+#include "multithread/multithread.h"
 
 
 #define NUM_SHIP_SUBSYSTEM_SETS			20		// number of subobject sets to use (because of the fact that it's a linked list,
@@ -398,6 +400,14 @@ static int Ship_cargo_check_timer;
 
 static int Thrust_anim_inited = 0;
 
+// ships whose local post-move processing is being held back for ship_finish_post_local()
+static bool Ship_post_local_deferred = false;
+static float Ship_post_local_frametime;
+static SCP_vector<object*> Ship_post_local_queue;
+
+// don't bother handing fewer ships than this to a thread
+#define SHIP_POST_LOCAL_MIN_PER_CHUNK	8
+
 bool warning_too_many_ship_classes = false;
 
 int ship_get_subobj_model_num(ship_info* sip, char* subobj_name);
@@ -1470,18 +1480,11 @@ int parse_ship_values(ship_info* sip, bool isTemplate, bool first_time, bool rep
 	if (optional_string("$Species:")) {
 		char temp[NAME_LENGTH];
 		stuff_string(temp, F_NAME, NAME_LENGTH);
-		int i_species = 0;
-		
-		bool found = false;
-		for (SCP_vector<species_info>::iterator sii = Species_info.begin(); sii != Species_info.end(); ++sii, ++i_species) {
-			if (!stricmp(temp, sii->species_name)) {
-				sip->species = i_species;
-				found = true;
-				break;
-			}
-		}
+		int i_species = species_info_lookup(temp);
 
-		if (!found) {
+		if (i_species >= 0) {
+			sip->species = i_species;
+		} else {
 			Error(LOCATION, "Invalid Species %s defined in table entry for ship %s.\n", temp, sip->name);
 		}
 	}
@@ -4429,6 +4432,7 @@ void ship_init()
 		{			
 			Num_engine_wash_types = 0;
 			Num_ship_classes = 0;
+			ship_info_lookup_invalidate();
 			strcpy_s(default_player_ship, "");
 
 			// static alias stuff - stupid, but it seems to be necessary
@@ -8519,8 +8523,6 @@ void ship_process_post(object * obj, float frametime)
 			shipfx_do_damaged_arcs_frame( shipp );
 		}
 
-		// JAS - flicker the thruster bitmaps
-		ship_do_thruster_frame(shipp,obj,frametime);		
 	}
 
 	ship_auto_repair_frame(num, frametime);
@@ -8637,6 +8639,82 @@ void ship_process_post(object * obj, float frametime)
 }
 
 
+/**
+ * The part of a ship's post-move processing which only reads and writes the ship's own state: the thruster
+ * animation and the ship's model instance (subsystem angles, dumb rotation and the collision transforms).
+ * Since nothing else is touched, any number of ships can go through this at once.
+ */
+static void ship_do_post_local(object *objp, float frametime)
+{
+	// JAS - flicker the thruster bitmaps
+	if ( !(Game_mode & GM_STANDALONE_SERVER) )
+		ship_do_thruster_frame(&Ships[objp->instance], objp, frametime);
+
+	ship_model_update_instance(objp);
+}
+
+/**
+ * Called after ship_process_post().  Does the ship's local post-move processing right away, or queues it up for
+ * ship_finish_post_local() if ship_defer_post_local() was called first.
+ */
+void ship_process_post_local(object *objp, float frametime)
+{
+	Assert( objp->type == OBJ_SHIP );
+
+	if ( !Ship_post_local_deferred ) {
+		ship_do_post_local(objp, frametime);
+		return;
+	}
+
+	Assert( frametime == Ship_post_local_frametime );
+	Ship_post_local_queue.push_back(objp);
+}
+
+/**
+ * Holds back the local post-move processing of every ship until ship_finish_post_local() is called.  Used by
+ * obj_move_all() so that the work can be spread over the worker threads once all ships have moved.
+ */
+void ship_defer_post_local(float frametime)
+{
+	Ship_post_local_deferred = true;
+	Ship_post_local_frametime = frametime;
+	Ship_post_local_queue.clear();
+}
+
+static void ship_post_local_job(int i)
+{
+	object *objp = Ship_post_local_queue[i];
+
+	// the ship may have been deleted outright after it was queued
+	if (objp->type != OBJ_SHIP)
+		return;
+
+	ship_do_post_local(objp, Ship_post_local_frametime);
+}
+
+/**
+ * Does the local post-move processing queued up since ship_defer_post_local(), spread over the worker threads.
+ * Anything with effects outside of a ship (sounds, particles, hooks, other objects) has already happened in
+ * ship_process_post() in object order, so the result doesn't depend on how the ships are split up.
+ */
+void ship_finish_post_local()
+{
+	Assert( Ship_post_local_deferred );
+	Ship_post_local_deferred = false;
+
+	if (Ship_post_local_queue.empty())
+		return;
+
+	// loads bitmaps, so it can't be left to the threads
+	if ( !Thrust_anim_inited && !(Game_mode & GM_STANDALONE_SERVER) )
+		ship_init_thrusters();
+
+	multithread_run_jobs(ship_post_local_job, (int)Ship_post_local_queue.size(), SHIP_POST_LOCAL_MIN_PER_CHUNK);
+
+	Ship_post_local_queue.clear();
+}
+
+
 /**
  * Set the ship level weapons based on the information contained in the ship info.
  * 
@@ -11949,18 +12027,27 @@ int wing_lookup(const char *name)
 	return -1;
 }
 
+static name_index Ship_info_index;
+
+static const char *ship_info_name(int idx)
+{
+	return Ship_info[idx].name;
+}
+
 /**
  * Return the index of Ship_info[].name that is *token.
  */
 int ship_info_lookup_sub(const char *token)
 {
-	int	i;
-
-	for (i = 0; i < Num_ship_classes; i++)
-		if (!stricmp(token, Ship_info[i].name))
-			return i;
+	return Ship_info_index.lookup(token, Num_ship_classes, ship_info_name);
+}
 
-	return -1;
+/**
+ * Call after renaming or reordering Ship_info entries.
+ */
+void ship_info_lookup_invalidate()
+{
+	Ship_info_index.invalidate();
 }
 
 /**
@@ -12117,6 +12204,13 @@ int ship_name_lookup(const char *name, int inc_players)
 	return -1;
 }
 
+static name_index Ship_type_index;
+
+static const char *ship_type_name(int idx)
+{
+	return Ship_types[idx].name;
+}
+
 int ship_type_name_lookup(const char *name)
 {
 	// bogus
@@ -12124,15 +12218,7 @@ int ship_type_name_lookup(const char *name)
 		return -1;
 	}
 
-	//Look through Ship_types array
-	uint max_size = Ship_types.size();
-	for(uint idx=0; idx < max_size; idx++){
-		if(!stricmp(name, Ship_types[idx].name)){
-			return idx;
-		}
-	}
-	// couldn't find it
-	return -1;
+	return Ship_type_index.lookup(name, (int)Ship_types.size(), ship_type_name);
 }
 
 // checks the (arrival & departure) state of a ship.  Return values:
@@ -17598,18 +17684,16 @@ void ArmorType::ParseData()
 
 //********************************Global functions
 
+static name_index Armor_type_index;
+
+static const char *armor_type_name(int idx)
+{
+	return Armor_types[idx].GetNamePtr();
+}
+
 int armor_type_get_idx(char* name)
 {
-	int i, num;
-	num = Armor_types.size();
-	for(i = 0; i < num; i++)
-	{
-		if(Armor_types[i].IsName(name))
-			return i;
-	}
-	
-	//Didn't find anything.
-	return -1;
+	return Armor_type_index.lookup(name, (int)Armor_types.size(), armor_type_name);
 }
 
 void parse_armor_type()
@@ -1570,6 +1570,9 @@ extern void change_ship_type(int n, int ship_type, int by_sexp = 0);
 extern void ship_model_change(int n, int ship_type);
 extern void ship_process_pre( object * objp, float frametime );
 extern void ship_process_post( object * objp, float frametime );
+extern void ship_process_post_local( object * objp, float frametime );
+extern void ship_defer_post_local( float frametime );
+extern void ship_finish_post_local();
 extern void ship_render( object * objp );
 extern void ship_render_cockpit( object * objp);
 extern void ship_render_show_ship_cockpit( object * objp);
@@ -1622,6 +1625,7 @@ extern int ship_template_lookup(const char *name = NULL);
 void parse_ship_particle_effect(ship_info* sip, particle_effect* pe, char *id_string);
 
 extern int ship_info_lookup(const char *name = NULL);
+extern void ship_info_lookup_invalidate();
 extern int ship_name_lookup(const char *name, int inc_players = 0);	// returns the index into Ship array of name
 extern int ship_type_name_lookup(const char *name);
 
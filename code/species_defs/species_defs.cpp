@@ -16,10 +16,30 @@
 #include "iff_defs/iff_defs.h"
 #include "graphics/generic.h"
 #include "localization/localize.h"
+#include "globalincs/name_index.h"
 
 
 SCP_vector<species_info> Species_info;
 
+static name_index Species_index;
+
+static const char *species_info_name(int idx)
+{
+	return Species_info[idx].species_name;
+}
+
+// returns the index into Species_info of the named species, or -1
+int species_info_lookup(const char *name)
+{
+	return Species_index.lookup(name, (int)Species_info.size(), species_info_name);
+}
+
+// call after renaming Species_info entries
+void species_info_lookup_invalidate()
+{
+	Species_index.invalidate();
+}
+
 //+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 
 // This function parses the data from the species_defs.tbl
@@ -200,14 +220,9 @@ void parse_species_tbl(const char *filename)
 		{
 			no_create = true;
 
-			for (i = 0; i < (int)Species_info.size(); i++)
-			{
-				if (!stricmp(Species_info[i].species_name, species_name))
-				{
-					species = &Species_info[i];
-					break;
-				}
-			}
+			i = species_info_lookup(species_name);
+			if (i >= 0)
+				species = &Species_info[i];
 		}
 		else
 		{
@@ -222,13 +237,11 @@ void parse_species_tbl(const char *filename)
 			stuff_string(temp_name, F_NAME, NAME_LENGTH);
 
 			// search for it in iffs
-			for (int iLoop = 0; iLoop < Num_iffs; iLoop++)
+			int iff_idx = iff_lookup(temp_name);
+			if (iff_idx >= 0)
 			{
-				if (!stricmp(Iff_info[iLoop].iff_name, temp_name))
-				{
-					species->default_iff = iLoop;
-					iff_found = true;
-				}
+				species->default_iff = iff_idx;
+				iff_found = true;
 			}
 
 			if (!iff_found)
@@ -367,6 +380,7 @@ void species_init()
 		return;
 
 	Species_info.clear();
+	species_info_lookup_invalidate();
 
 
 	if (cf_exists_full("species_defs.tbl", CF_TYPE_TABLES))
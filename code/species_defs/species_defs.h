@@ -92,4 +92,8 @@ extern SCP_vector<species_info> Species_info;
 // IMPORTANT: If Num_species != 3, icons.tbl, asteroid.tbl, and sounds.tbl have to be modified to compensate!
 void species_init();
 
+// find a species by name
+int species_info_lookup(const char *name);
+void species_info_lookup_invalidate();
+
 #endif
@@ -209,9 +209,6 @@ void beam_add_collision(beam *b, object *hit_object, mc_info *cinfo, int quad =
 // sort collisions for the frame
 int beam_sort_collisions_func(const void *e1, const void *e2);
 
-// get the width of the widest section of the beam
-float beam_get_widest(beam *b);
-
 // mark an object as being lit
 void beam_add_light(beam *b, int objnum, int source, vec3d *c_point);
 
@@ -3528,6 +3525,7 @@ collision_result beam_collide_ship_eval(obj_pair *pair, collision_exec_data *dat
 	shipp = &Ships[pair->b->instance];
 
 	int valid_hit_occurred = 0;
+	data->beam_ship.quadrant_num = -1;
 	sip = &Ship_info[shipp->ship_info_index];
 	bwi = &Weapon_info[data->beam_ship.b->weapon_info_index];
 
@@ -236,6 +236,9 @@ void beam_render_all();
 // early-out function for when adding object collision pairs, return 1 if the pair should be ignored
 int beam_collide_early_out(object *a, object *b);
 
+// get the width of the widest section of the beam
+float beam_get_widest(beam *b);
+
 // pause all looping beam sounds
 void beam_pause_sounds();
 
@@ -14,29 +14,67 @@
 #include "render/3d.h" 
 #include "io/timer.h"
 #include "ship/ship.h"
+#include "cmdline/cmdline.h"
 
 
+#define TRAIL_BLOCK_SIZE	64		// trails allocated at once when the pool runs dry
+
 int Num_trails;
-trail Trails;
+
+// Every trail comes out of one of these blocks, so swarms of missiles creating and killing trails
+// never go near the heap.  Unused trails are chained through trail::next.
+static SCP_vector<trail*> Trail_blocks;
+static trail *Trail_free_list = NULL;
+
+// live trails, oldest first
+static SCP_vector<trail*> Trails;
+
+int Trail_buffer_object = -1;
+
+static void trail_free(trail *trailp)
+{
+	trailp->next = Trail_free_list;
+	Trail_free_list = trailp;
+
+	// decrement counter
+	Num_trails--;
+}
 
 // Reset everything between levels
 void trail_level_init()
 {
+	size_t i;
+	int j;
+
+	// hand every trail back to the pool
+	Trail_free_list = NULL;
+
+	for (i = 0; i < Trail_blocks.size(); i++) {
+		for (j = TRAIL_BLOCK_SIZE - 1; j >= 0; j--) {
+			Trail_blocks[i][j].next = Trail_free_list;
+			Trail_free_list = &Trail_blocks[i][j];
+		}
+	}
+
+	Trails.clear();
 	Num_trails = 0;
-	Trails.next = &Trails;
+
+	// grab a vertex buffer object
+	if ( (Trail_buffer_object < 0) && !Cmdline_nohtl ) {
+		Trail_buffer_object = gr_create_stream_buffer();
+	}
 }
 
 void trail_level_close()
 {
-	trail *nextp;
-	for(trail *trailp = Trails.next; trailp != &Trails; trailp = nextp)
-	{
-		nextp = trailp->next;
-
-		//Now we can delete it
-		delete trailp;
+	for (size_t i = 0; i < Trail_blocks.size(); i++) {
+		delete [] Trail_blocks[i];
 	}
 
+	Trail_blocks.clear();
+	Trail_free_list = NULL;
+	Trails.clear();
+
 	Num_trails=0;
 }
 
@@ -49,8 +87,19 @@ trail *trail_create(trail_info *info)
 	if((Game_mode & GM_STANDALONE_SERVER) || !Detail.weapon_extras)
 		return NULL;
 
-	// Make a new trail
-	trail *trailp = new trail;
+	// the pool is dry, so add another block to it
+	if (Trail_free_list == NULL) {
+		trail *block = new trail[TRAIL_BLOCK_SIZE];
+		Trail_blocks.push_back(block);
+
+		for (int i = TRAIL_BLOCK_SIZE - 1; i >= 0; i--) {
+			block[i].next = Trail_free_list;
+			Trail_free_list = &block[i];
+		}
+	}
+
+	trail *trailp = Trail_free_list;
+	Trail_free_list = trailp->next;
 
 	// increment counter
 	Num_trails++;
@@ -61,15 +110,24 @@ trail *trail_create(trail_info *info)
 	trailp->head = 0;	
 	trailp->object_died = false;		
 	trailp->trail_stamp = timestamp(trailp->info.stamp);
+	trailp->next = NULL;
 
-	//Add it to the front of the list
-	//This is quickest since there are no prev vars
-	trailp->next = Trails.next;
-	Trails.next = trailp;
+	Trails.push_back(trailp);
 
 	return trailp;
 }
 
+// number of segments between the head and the tail of the ring
+static int trail_num_segments(trail *trailp)
+{
+	int count = trailp->tail - trailp->head;
+
+	if (count < 0)
+		count += NUM_TRAIL_SECTIONS;
+
+	return count;
+}
+
 // output top and bottom vectors
 // fvec == forward vector (eye viewpoint basically. in world coords)
 // pos == world coordinate of the point we're calculating "around"
@@ -108,17 +166,34 @@ int trail_is_on_ship(trail *trailp, ship *shipp)
 
 // Render the trail behind a missile.
 // Basically a queue of points that face the viewer
-extern int Cmdline_nohtl;
 
+// the tristrips of every trail drawn this frame, one after the other
 static vertex *Trail_v_list = NULL;
 static int Trail_verts_allocated = 0;
 
+// Trail_v_list converted for the stream buffer
+static effect_vertex *Trail_buffer = NULL;
+static int Trail_buffer_allocated = 0;
+
+typedef struct trail_draw {
+	trail *trailp;
+	int offset;		// first vertex in Trail_v_list
+	int n_verts;
+} trail_draw;
+
+static SCP_vector<trail_draw> Trail_draws;
+
 static void deallocate_trail_verts()
 {
 	if (Trail_v_list != NULL) {
 		vm_free(Trail_v_list);
 		Trail_v_list = NULL;
 	}
+
+	if (Trail_buffer != NULL) {
+		vm_free(Trail_buffer);
+		Trail_buffer = NULL;
+	}
 }
 
 static void allocate_trail_verts(int num_verts)
@@ -149,7 +224,9 @@ static void allocate_trail_verts(int num_verts)
 	}
 }
 
-void trail_render( trail * trailp )
+// builds the tristrip for a trail into verts, returning the number of vertices in it
+// (verts needs room for 2 per segment, plus 1)
+static int trail_build_verts( trail * trailp, vertex *verts )
 {
 	int sections[NUM_TRAIL_SECTIONS];
 	int num_sections = 0;
@@ -162,13 +239,13 @@ void trail_render( trail * trailp )
 	vec3d centerv;
 
 	if (trailp->tail == trailp->head)
-		return;
+		return 0;
 
 	// if this trail is on the player ship, and he's in any padlock view except rear view, don't draw	
 	if ( (Player_ship != NULL) && trail_is_on_ship(trailp, Player_ship) &&
 		(Viewer_mode & (VM_PADLOCK_UP | VM_PADLOCK_LEFT | VM_PADLOCK_RIGHT)) )
 	{
-		return;
+		return 0;
 	}
 
 	trail_info *ti	= &trailp->info;
@@ -188,16 +265,13 @@ void trail_render( trail * trailp )
 	} while ( n != trailp->head );
 
 	if (num_sections <= 0)
-		return;
+		return 0;
 
 	Assertion(ti->texture.bitmap_id != -1, "Weapon trail %s could not be loaded", ti->texture.filename); // We can leave this as an assert, but tell them how to fix it. --Chief
 
 	memset( &top, 0, sizeof(vertex) );
 	memset( &bot, 0, sizeof(vertex) );
 
-	// it's a tristrip, so allocate for 2+1
-	allocate_trail_verts((num_sections * 2) + 1);
-
 	float w_size = (ti->w_end - ti->w_start);
 	float a_size = (ti->a_end - ti->a_start);
 	int num_faded_sections = ti->n_fade_out_sections;
@@ -254,47 +328,50 @@ void trail_render( trail * trailp )
 				vm_vec_avg( &centerv, &topv, &botv );
 
 				if ( !Cmdline_nohtl )
-					g3_transfer_vertex( &Trail_v_list[nv+2], &centerv );
+					g3_transfer_vertex( &verts[nv+2], &centerv );
 				else
-					g3_rotate_vertex( &Trail_v_list[nv+2], &centerv );
+					g3_rotate_vertex( &verts[nv+2], &centerv );
+
+				// the tip fades out to nothing
+				verts[nv+2].a = 0;
 
-				Trail_v_list[nv].a = l;	
+				verts[nv].a = l;	
 
-				Trail_v_list[nv].texture_position.u = U;
-				Trail_v_list[nv].texture_position.v = 1.0f; 
-				Trail_v_list[nv].r = Trail_v_list[nv].g = Trail_v_list[nv].b = l;
+				verts[nv].texture_position.u = U;
+				verts[nv].texture_position.v = 1.0f; 
+				verts[nv].r = verts[nv].g = verts[nv].b = l;
 				nv++;
 
-				Trail_v_list[nv].texture_position.u = U;
-				Trail_v_list[nv].texture_position.v = 0.0f; 
-				Trail_v_list[nv].r = Trail_v_list[nv].g = Trail_v_list[nv].b = l;
+				verts[nv].texture_position.u = U;
+				verts[nv].texture_position.v = 0.0f; 
+				verts[nv].r = verts[nv].g = verts[nv].b = l;
 				nv++;
 
-				Trail_v_list[nv].texture_position.u = U + 1.0f;
-				Trail_v_list[nv].texture_position.v = 0.5f;
-				Trail_v_list[nv].r = Trail_v_list[nv].g = Trail_v_list[nv].b = 0;
+				verts[nv].texture_position.u = U + 1.0f;
+				verts[nv].texture_position.v = 0.5f;
+				verts[nv].r = verts[nv].g = verts[nv].b = 0;
 				nv++;
 			} else {
-				Trail_v_list[nv].texture_position.u = U;
-				Trail_v_list[nv].texture_position.v = 1.0f; 
-				Trail_v_list[nv].r = Trail_v_list[nv].g = Trail_v_list[nv].b = l;
+				verts[nv].texture_position.u = U;
+				verts[nv].texture_position.v = 1.0f; 
+				verts[nv].r = verts[nv].g = verts[nv].b = l;
 				nv++;
 
-				Trail_v_list[nv].texture_position.u = U;
-				Trail_v_list[nv].texture_position.v = 0.0f; 
-				Trail_v_list[nv].r = Trail_v_list[nv].g = Trail_v_list[nv].b = l;
+				verts[nv].texture_position.u = U;
+				verts[nv].texture_position.v = 0.0f; 
+				verts[nv].r = verts[nv].g = verts[nv].b = l;
 				nv++;
 			}
 		}
 
 		last_pos = trailp->pos[n];
-		Trail_v_list[nv] = top;
-		Trail_v_list[nv+1] = bot;
+		verts[nv] = top;
+		verts[nv+1] = bot;
 	}
 
 
 	if ( !nv )
-		return;
+		return 0;
 
 	if (nv < 3)
 		Error( LOCATION, "too few verts in trail render\n" );
@@ -304,8 +381,7 @@ void trail_render( trail * trailp )
 		Warning( LOCATION, "even number of verts in trail render\n" );
 
 
-	gr_set_bitmap( ti->texture.bitmap_id, GR_ALPHABLEND_FILTER, GR_BITBLT_MODE_NORMAL, 1.0f );
-	gr_render(nv, Trail_v_list, TMAP_FLAG_TEXTURED | TMAP_FLAG_ALPHA | TMAP_FLAG_GOURAUD | TMAP_FLAG_RGB | TMAP_HTL_3D_UNLIT | TMAP_FLAG_TRISTRIP);
+	return nv;
 }
 
 
@@ -338,47 +414,59 @@ void trail_set_segment( trail *trailp, vec3d *pos )
 	trailp->pos[next] = *pos;
 }
 
-void trail_move_all(float frametime)
+// Ages every segment of a trail and drops the dead ones off the old end of the ring.  Returns the
+// number of segments still alive.
+static int trail_age(trail *trailp, float time_delta)
 {
-	int num_alive_segments,n;
-	float time_delta;
-	trail *next_trail;
-	trail *prev_trail = &Trails;
+	int head = trailp->head;
+	int tail = trailp->tail;
+	float *val = trailp->val;
+	int i;
 
-	for (trail *trailp = Trails.next; trailp != &Trails; trailp = next_trail) {
-		next_trail = trailp->next;
+	if (head == tail)
+		return 0;
 
-		num_alive_segments = 0;
+	// the live part of the ring is at most two straight runs, which the compiler can vectorize
+	int end = (tail > head) ? tail : NUM_TRAIL_SECTIONS;
 
-		if ( trailp->tail != trailp->head )	{
-			n = trailp->tail;			
-			time_delta = frametime / trailp->info.max_life;
-			do	{
-				n--;
-				if ( n < 0 ) n = NUM_TRAIL_SECTIONS-1;
+	for (i = head; i < end; i++)
+		val[i] += time_delta;
 
-				trailp->val[n] += time_delta;
+	if (tail < head) {
+		for (i = 0; i < tail; i++)
+			val[i] += time_delta;
+	}
 
-				if ( trailp->val[n] <= 1.0f ) {
-					num_alive_segments++;	// Record how many still alive.
-				}
+	// every segment starts at zero and they all age together, so the dead ones are always at the head
+	while ( (head != tail) && (val[head] > 1.0f) ) {
+		head++;
+		if (head >= NUM_TRAIL_SECTIONS)
+			head = 0;
+	}
 
-			} while ( n != trailp->head );
-		}		
-	
-		if ( (num_alive_segments < 1) && trailp->object_died)
-		{
-			prev_trail->next = trailp->next;
-			delete trailp;
+	trailp->head = head;
 
-			// decrement counter
-			Num_trails--;
-		}
-		else
-		{
-			prev_trail = trailp;
+	return trail_num_segments(trailp);
+}
+
+void trail_move_all(float frametime)
+{
+	size_t i, num_live = 0;
+
+	for (i = 0; i < Trails.size(); i++) {
+		trail *trailp = Trails[i];
+
+		int num_alive_segments = trail_age(trailp, frametime / trailp->info.max_life);
+
+		if ( (num_alive_segments < 1) && trailp->object_died ) {
+			trail_free(trailp);
+		} else {
+			// keep the survivors in order
+			Trails[num_live++] = trailp;
 		}
 	}
+
+	Trails.resize(num_live);
 }
 
 void trail_object_died( trail *trailp )
@@ -388,16 +476,84 @@ void trail_object_died( trail *trailp )
 
 void trail_render_all()
 {
+	int i, max_verts = 0, n_verts = 0;
+	int tmap_flags = TMAP_FLAG_TEXTURED | TMAP_FLAG_ALPHA | TMAP_FLAG_GOURAUD | TMAP_FLAG_RGB | TMAP_HTL_3D_UNLIT | TMAP_FLAG_TRISTRIP;
+
 	// No trails at slot 0
 	if ( !Detail.weapon_extras )
 		return;
 
-	for(trail *trailp = Trails.next; trailp!=&Trails; trailp = trailp->next )
-	{
-		trail_render(trailp);
+	if ( Trails.empty() )
+		return;
+
+	// it's a tristrip per trail, so allocate for 2+1 each
+	for (i = 0; i < (int)Trails.size(); i++) {
+		max_verts += (trail_num_segments(Trails[i]) * 2) + 1;
 	}
 
+	allocate_trail_verts(max_verts);
+
+	Trail_draws.clear();
+
+	// newest first, same as they always have been
+	for (i = (int)Trails.size() - 1; i >= 0; i--) {
+		int nv = trail_build_verts(Trails[i], &Trail_v_list[n_verts]);
+
+		if ( !nv )
+			continue;
+
+		trail_draw draw;
+		draw.trailp = Trails[i];
+		draw.offset = n_verts;
+		draw.n_verts = nv;
+		Trail_draws.push_back(draw);
+
+		n_verts += nv;
+	}
+
+	if ( Trail_draws.empty() )
+		return;
+
+	if ( (Trail_buffer_object < 0) || Cmdline_nohtl ) {
+		for (i = 0; i < (int)Trail_draws.size(); i++) {
+			gr_set_bitmap( Trail_draws[i].trailp->info.texture.bitmap_id, GR_ALPHABLEND_FILTER, GR_BITBLT_MODE_NORMAL, 1.0f );
+			gr_render( Trail_draws[i].n_verts, &Trail_v_list[Trail_draws[i].offset], tmap_flags );
+		}
+
+		return;
+	}
+
+	// one upload for every trail this frame, then a draw per trail out of it
+	if (Trail_buffer_allocated < n_verts) {
+		if (Trail_buffer != NULL) {
+			vm_free(Trail_buffer);
+		}
+
+		Trail_buffer = (effect_vertex*) vm_malloc( max_verts * sizeof(effect_vertex) );
+		Trail_buffer_allocated = max_verts;
+	}
+
+	for (i = 0; i < n_verts; i++) {
+		Trail_buffer[i].position = Trail_v_list[i].world;
+		Trail_buffer[i].tex_coord = Trail_v_list[i].texture_position;
+		Trail_buffer[i].radius = 0.0f;
+		Trail_buffer[i].r = Trail_v_list[i].r;
+		Trail_buffer[i].g = Trail_v_list[i].g;
+		Trail_buffer[i].b = Trail_v_list[i].b;
+		Trail_buffer[i].a = Trail_v_list[i].a;
+	}
+
+	gr_render_stream_buffer_start(Trail_buffer_object);
+	gr_update_stream_buffer(Trail_buffer_object, Trail_buffer, n_verts * sizeof(effect_vertex));
+
+	for (i = 0; i < (int)Trail_draws.size(); i++) {
+		gr_set_bitmap( Trail_draws[i].trailp->info.texture.bitmap_id, GR_ALPHABLEND_FILTER, GR_BITBLT_MODE_NORMAL, 1.0f );
+		gr_render_stream_buffer( Trail_draws[i].offset, Trail_draws[i].n_verts, tmap_flags );
+	}
+
+	gr_render_stream_buffer_end();
 }
+
 int trail_stamp_elapsed(trail *trailp)
 {
 	return timestamp_elapsed(trailp->trail_stamp);
@@ -41,7 +41,7 @@ typedef struct trail {
 	// trail info
 	trail_info info;							// this is passed when creating a trail
 
-	struct	trail * next;
+	struct	trail * next;					// next unused trail while it sits in the pool
 
 } trail;
 
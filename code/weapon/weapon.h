@@ -594,6 +594,7 @@ extern int Player_weapon_precedence[MAX_WEAPON_TYPES];	// Array of weapon types,
 
 
 int weapon_info_lookup(const char *name = NULL);
+void weapon_info_lookup_invalidate();
 void weapon_init();					// called at game startup
 void weapon_close();				// called at game shutdown
 void weapon_level_init();			// called before the start of each level
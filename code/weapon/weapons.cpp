@@ -47,6 +47,7 @@
 #include "parse/scripting.h"
 #include "stats/scoring.h"
 #include "mod_table/mod_table.h"
+#include "globalincs/name_index.h"
 
 
 #ifndef NDEBUG
@@ -447,6 +448,13 @@ missile_obj *missile_obj_return_address(int index)
 	return &Missile_objs[index];
 }
 
+static name_index Weapon_info_index;
+
+static const char *weapon_info_name(int idx)
+{
+	return Weapon_info[idx].name;
+}
+
 /**
  * Return the index of Weapon_info[].name that is *name.
  */
@@ -456,11 +464,15 @@ int weapon_info_lookup(const char *name)
 	if (name == NULL)
 		return -1;
 
-	for (int i=0; i<Num_weapon_types; i++)
-		if (!stricmp(name, Weapon_info[i].name))
-			return i;
+	return Weapon_info_index.lookup(name, Num_weapon_types, weapon_info_name);
+}
 
-	return -1;
+/**
+ * Call after renaming or reordering Weapon_info entries.
+ */
+void weapon_info_lookup_invalidate()
+{
+	Weapon_info_index.invalidate();
 }
 
 #define DEFAULT_WEAPON_SPAWN_COUNT	10
@@ -3013,6 +3025,8 @@ void weapon_sort_by_type()
 	if (big_missiles)	delete [] big_missiles;
 	if (child_primaries)	delete [] child_primaries;
 	if (child_secondaries)	delete [] child_secondaries;
+
+	weapon_info_lookup_invalidate();
 }
 
 /**
@@ -3401,6 +3415,7 @@ void weapon_init()
 
 		Num_weapon_types = 0;
 		Num_spawn_types = 0;
+		weapon_info_lookup_invalidate();
 
 		parse_weaponstbl("weapons.tbl");
 
@@ -593,6 +593,10 @@ SOURCE=..\..\code\GlobalIncs\LinkList.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\code\GlobalIncs\name_index.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\code\globalincs\mspdb_callstack.cpp
 # End Source File
 # Begin Source File
@@ -1613,10 +1617,18 @@ SOURCE=..\..\code\Network\multi_log.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\code\Network\multi_metrics.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\code\Network\multi_log.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\code\Network\multi_metrics.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\code\Network\multi_obj.cpp
 # End Source File
 # Begin Source File
@@ -2169,6 +2181,10 @@ SOURCE=..\..\code\Render\3dClipper.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\code\Render\3dcommands.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\code\Render\3ddraw.cpp
 # End Source File
 # Begin Source File
@@ -2177,6 +2193,10 @@ SOURCE=..\..\code\Render\3dInternal.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\code\Render\3dcommands.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\code\Render\3dLaser.cpp
 # End Source File
 # Begin Source File